@@ -1,23 +1,25 @@
 #include <algorithm>
 
 #include "agents.hpp"
+#include "profiler.hpp"
 
-using std::cout;
 using std::vector;
 
 // using namespace environment;
 // using namespace agents;
 
 agents::Agent::Agent(){
-    cout << "Base constructor invoked Resetting action to hit in abstract base class\n\n";
+    environment::narration() << "Base constructor invoked Resetting action to hit in abstract base class\n\n";
     this->action = environment::Action::HIT;
-    cout << "Current action is " << this->action << "\n";
+    environment::narration() << "Current action is " << this->action << "\n";
 }
 
 agents::PassiveAgent::PassiveAgent() {}
 
 /* Passive agent performs no actions other than applying the fixed-policy to a given state */
 environment::Action agents::PassiveAgent::considerState(environment::GameState state){
+    PROFILE_SCOPE(profiler::Phase::AGENT_DECISION);
+
     // Once the agent chooses to stand it cannot choose otherwise until the game is over
     if (action == environment::Action::STAND) {
         return environment::Action::STAND;
@@ -34,13 +36,13 @@ environment::Action agents::PassiveAgent::considerState(environment::GameState s
 /* Enacts the agents policy depending on a given state */ 
 environment::Action agents::PassiveAgent::policy(environment::GameState state) {
     float probability = environment::getRandomFloat();
-    cout << "\nProbability value is -> " << probability << "\n";
+    environment::narration() << "\nProbability value is -> " << probability << "\n";
     // If player total is less than 18 then choose to hit with probability 80% 
     if (state.getPlayerTotal() < 18) {
-        cout << "Player Total is under 18, agent is biased towards hitting\n";
+        environment::narration() << "Player Total is under 18, agent is biased towards hitting\n";
         action = environment::Action(probability <= 0.80f);
     } else {
-        cout << "Player Total is greater than or equal to 18, agent is biased towards standing\n";
+        environment::narration() << "Player Total is greater than or equal to 18, agent is biased towards standing\n";
         // If player total is greater than 18 then choose to hit with probability 20%
         action = environment::Action(probability > 0.80f);
     }
@@ -67,6 +69,8 @@ agents::GreedyAgent::GreedyAgent(
     considering ~5000 states.
 */
 environment::Action agents::GreedyAgent::considerState(environment::GameState state){
+    PROFILE_SCOPE(profiler::Phase::AGENT_DECISION);
+
     // Once the agent chooses to stand it cannot choose otherwise until the game is over
     if (action == environment::Action::STAND) {
         return environment::Action::STAND;
@@ -134,4 +138,23 @@ environment::Action agents::GreedyAgent::policy(environment::GameState state){
     }
     
     return this->action;
-}
\ No newline at end of file
+}
+
+agents::PolicyAgent::PolicyAgent(const policy::FrozenPolicy &frozenPolicy) : frozenPolicy(frozenPolicy) {}
+
+environment::Action agents::PolicyAgent::considerState(environment::GameState state){
+    PROFILE_SCOPE(profiler::Phase::AGENT_DECISION);
+
+    // Once the agent chooses to stand it cannot choose otherwise until the game is over
+    if (action == environment::Action::STAND) {
+        return environment::Action::STAND;
+    }
+
+    return this->policy(state);
+}
+
+/* The frozen policy already hits below 12, so the decision is a single table lookup */
+environment::Action agents::PolicyAgent::policy(environment::GameState state){
+    action = frozenPolicy.decide(state);
+    return action;
+}
@@ -7,6 +7,7 @@
 #include <utility>
 #include "environment.hpp"
 #include "function.hpp"
+#include "policy.hpp"
 
 namespace agents{
     /*  The initial agent with a fixed policy.
@@ -25,6 +26,11 @@ namespace agents{
         virtual inline void reset(){
             this->action = environment::Action::HIT;
         }
+
+        /* Restores the choice of a game that was set aside, so one agent can take turns playing several games */
+        inline void resume(environment::Action action){
+            this->action = action;
+        }
     protected:
         /* The action the agent chooses at a given moment */
         environment::Action action;  
@@ -65,12 +71,30 @@ namespace agents{
                 return this->action;
             }
 
+            inline float getEpsilon() const{
+                return this->epsilon;
+            }
+
         private:
             /* Epsilon holds the probability of choosing a random action, in a given state*/
             float epsilon, decayRate, hitValue, standValue;
 
             environment::Action policy(environment::GameState state);
     };
+
+    /*  Plays a frozen policy exported from a trained function, with no exploration.
+        The policy is held by reference, so it must outlive the agent. */
+    class PolicyAgent: public Agent {
+        public:
+            PolicyAgent(const policy::FrozenPolicy &frozenPolicy);
+
+            environment::Action considerState(environment::GameState state);
+
+        private:
+            const policy::FrozenPolicy &frozenPolicy;
+
+            environment::Action policy(environment::GameState state);
+    };
     
 }
 
@@ -0,0 +1,190 @@
+#include "bankroll.hpp"
+
+#include <cmath>
+#include <chrono>
+#include <thread>
+#include <algorithm>
+
+bankroll::OutcomeStream bankroll::recordOutcomes(
+    const policy::FrozenPolicy &frozenPolicy,
+    long long numberOfHands,
+    const table::TableConfig &config
+){
+    OutcomeStream stream;
+    stream.rewards.reserve((std::size_t)std::max(0LL, numberOfHands));
+
+    table::Table table(config);
+    table.addSeat(frozenPolicy);
+
+    for (long long hand = 0; hand < numberOfHands; ++hand){
+        table.playRound();
+
+        float reward = environment::generateRewardValue(table.getOutcome(0));
+        stream.rewards.push_back((std::int8_t)reward);
+
+        stream.wins += reward > 0.0f;
+        stream.losses += reward < 0.0f;
+        stream.pushes += reward == 0.0f;
+    }
+
+    return stream;
+}
+
+double bankroll::kellyShare(const OutcomeStream &stream){
+    long long decided = stream.wins + stream.losses;
+    return decided > 0 ? std::max(0.0, (double)(stream.wins - stream.losses) / (double)decided) : 0.0;
+}
+
+bankroll::BankrollResult bankroll::simulate(const OutcomeStream &stream, const BankrollConfig &config){
+    auto start = std::chrono::steady_clock::now();
+
+    BankrollResult result;
+    result.kellyShare = kellyShare(stream);
+
+    long long numberOfSessions = std::max(0LL, config.numberOfSessions);
+    if (numberOfSessions == 0 || stream.rewards.empty()){
+        return result;
+    }
+
+    int numberOfThreads = config.numberOfThreads > 0
+        ? config.numberOfThreads
+        : std::max(1, (int)std::thread::hardware_concurrency());
+    numberOfThreads = (int)std::min<long long>(numberOfThreads, numberOfSessions);
+
+    // The share of the bankroll bet on each hand, 0 for flat betting, which always bets the minimum
+    double share = 0.0;
+    switch (config.sizing){
+        case BetSizing::FLAT:           share = 0.0; break;
+        case BetSizing::PROPORTIONAL:   share = config.proportion; break;
+        case BetSizing::KELLY:          share = config.kellyMultiplier * result.kellyShare; break;
+    }
+
+    // Indexed by session rather than by thread, so the results do not depend on how the sessions were split
+    std::vector<double> finalBankrolls((std::size_t)numberOfSessions);
+    std::vector<int> handsToRuin((std::size_t)numberOfSessions, -1);
+
+    const std::int8_t *rewards = stream.rewards.data();
+    const long long streamSize = (long long)stream.rewards.size();
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < numberOfThreads; ++t){
+        long long firstSession = numberOfSessions * t / numberOfThreads, lastSession = numberOfSessions * (t + 1) / numberOfThreads;
+
+        threads.emplace_back([&, firstSession, lastSession](){
+            for (long long group = firstSession; group < lastSession; group += SESSIONS_IN_STEP){
+                int lanes = (int)std::min<long long>(SESSIONS_IN_STEP, lastSession - group);
+
+                double bankrolls[SESSIONS_IN_STEP];
+                long long positions[SESSIONS_IN_STEP];
+                int ruinedAt[SESSIONS_IN_STEP];
+
+                for (int lane = 0; lane < SESSIONS_IN_STEP; ++lane){
+                    environment::RandomEngine engine(config.seed, (std::uint64_t)(group + lane));
+                    positions[lane] = (long long)(engine() % (environment::RandomEngine::result_type)std::min<long long>(streamSize, 0xFFFFFFFFLL));
+                    bankrolls[lane] = config.initialBankroll;
+                    ruinedAt[lane] = bankrolls[lane] < config.minimumBet ? 0 : -1;
+                }
+
+                /*  The sessions of a group are stepped a hand at a time together, so the bets of one do not wait on the
+                    bankroll of the hand before as they would session by session. A ruined session bets nothing more. */
+                for (int hand = 0; hand < config.handsPerSession; ++hand){
+                    int live = 0;
+
+                    for (int lane = 0; lane < SESSIONS_IN_STEP; ++lane){
+                        double bankroll = bankrolls[lane];
+                        bool playing = bankroll >= config.minimumBet;
+                        double bet = playing ? std::min(bankroll, std::max(config.minimumBet, share * bankroll)) : 0.0;
+
+                        bankroll += bet * rewards[positions[lane]];
+                        bankrolls[lane] = bankroll;
+
+                        // The window wraps around the end of the stream when it is longer than what is left of it
+                        positions[lane] = positions[lane] + 1 == streamSize ? 0 : positions[lane] + 1;
+
+                        bool ruined = playing && bankroll < config.minimumBet;
+                        ruinedAt[lane] = ruined ? hand + 1 : ruinedAt[lane];
+                        live += playing;
+                    }
+
+                    if (live == 0){
+                        break;
+                    }
+                }
+
+                for (int lane = 0; lane < lanes; ++lane){
+                    finalBankrolls[group + lane] = bankrolls[lane];
+                    handsToRuin[group + lane] = ruinedAt[lane];
+                }
+            }
+        });
+    }
+
+    for (std::thread &thread: threads){
+        thread.join();
+    }
+
+    result.sessions = numberOfSessions;
+
+    double bankrollSum = 0.0;
+    for (double bankroll: finalBankrolls){
+        bankrollSum += bankroll;
+    }
+    result.meanFinalBankroll = bankrollSum / (double)numberOfSessions;
+
+    // Selecting each quantile in turn leaves the ones below it in place, so each selection only searches above the last
+    auto quantileStart = finalBankrolls.begin();
+    for (std::size_t q = 0; q < FINAL_BANKROLL_QUANTILES.size(); ++q){
+        auto nth = finalBankrolls.begin() + (std::ptrdiff_t)std::llround(FINAL_BANKROLL_QUANTILES[q] * (double)(numberOfSessions - 1));
+        std::nth_element(quantileStart, nth, finalBankrolls.end());
+        result.finalBankrollQuantiles[q] = *nth;
+        quantileStart = nth;
+    }
+
+    std::vector<int> ruinTimes;
+    for (int hands: handsToRuin){
+        if (hands >= 0){
+            ruinTimes.push_back(hands);
+        }
+    }
+
+    result.ruinedSessions = (long long)ruinTimes.size();
+    result.riskOfRuin = (double)result.ruinedSessions / (double)numberOfSessions;
+    result.independentSessions = std::max(1LL, std::min(numberOfSessions, streamSize / std::max(1, config.handsPerSession)));
+    result.standardError = std::sqrt(result.riskOfRuin * (1.0 - result.riskOfRuin) / (double)result.independentSessions);
+
+    if (!ruinTimes.empty()){
+        double ruinSum = 0.0;
+        for (int hands: ruinTimes){
+            ruinSum += hands;
+        }
+        result.meanHandsToRuin = ruinSum / (double)ruinTimes.size();
+
+        auto median = ruinTimes.begin() + (std::ptrdiff_t)(ruinTimes.size() / 2);
+        std::nth_element(ruinTimes.begin(), median, ruinTimes.end());
+        result.medianHandsToRuin = *median;
+    }
+
+    result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return result;
+}
+
+std::ostream& operator<<(std::ostream& o, const bankroll::BankrollResult &r){
+    o << r.sessions << " sessions in " << r.seconds << "s\n" <<
+        "Risk of ruin = " << r.riskOfRuin << " +/- " << r.standardError << " (" << r.ruinedSessions << " ruined)\n";
+
+    if (r.independentSessions < r.sessions){
+        o << "The sessions share the stream's hands, so the error is that of its " << r.independentSessions <<
+            " non-overlapping sessions, record more --hands to narrow it\n";
+    }
+
+    if (r.ruinedSessions > 0){
+        o << "Hands to ruin: mean = " << r.meanHandsToRuin << ", median = " << r.medianHandsToRuin << "\n";
+    }
+
+    o << "Final bankroll: mean = " << r.meanFinalBankroll;
+    for (std::size_t q = 0; q < bankroll::FINAL_BANKROLL_QUANTILES.size(); ++q){
+        o << ", " << (int)std::lround(100.0 * bankroll::FINAL_BANKROLL_QUANTILES[q]) << "% = " << r.finalBankrollQuantiles[q];
+    }
+    o << "\nKelly share = " << r.kellyShare << "\n";
+    return o;
+}
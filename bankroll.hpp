@@ -0,0 +1,102 @@
+#pragma once
+
+#ifndef BANKROLL_H
+
+#define BANKROLL_H
+
+#include <array>
+#include <vector>
+#include <cstdint>
+#include "table.hpp"
+
+/*  Simulates many independent betting sessions of a fixed policy to measure its risk of ruin. The hands are played
+    once, into a stream of outcomes, and every session bets its way along a window of that stream, so a session costs
+    a few arithmetic operations per hand rather than a deal. */
+namespace bankroll {
+
+    /* The starting bankroll and bet of the original training loop, which bets 5 while it has 5 to bet */
+    const double DEFAULT_INITIAL_BANKROLL = 1000.0;
+    const double DEFAULT_MINIMUM_BET = 5.0;
+
+    const double DEFAULT_PROPORTION = 0.01;
+
+    /* Half of the Kelly bet, which gives up a quarter of the growth for far smaller swings */
+    const double DEFAULT_KELLY_MULTIPLIER = 0.5;
+
+    /* Sessions a thread steps through their hands together, enough to overlap the latency of their bankroll updates */
+    const int SESSIONS_IN_STEP = 8;
+
+    /* The shares of sessions below which the reported final bankrolls lie */
+    const std::array<double, 5> FINAL_BANKROLL_QUANTILES = {0.05, 0.25, 0.5, 0.75, 0.95};
+
+    enum class BetSizing :int {
+        FLAT = 0,       // The minimum bet on every hand
+        PROPORTIONAL,   // A fixed share of the current bankroll
+        KELLY           // A multiple of the Kelly share, the share that maximises the expected growth of the bankroll
+    };
+
+    /*  The rewards of consecutive hands played by one seat of a table, -1, 0 or 1 each. Consecutive hands come from
+        the same shoe, so a window of the stream keeps the way a shoe's hands depend on each other. */
+    struct OutcomeStream {
+        std::vector<std::int8_t> rewards;
+        long long wins = 0, losses = 0, pushes = 0;
+    };
+
+    struct BankrollConfig {
+        long long numberOfSessions = 100000;
+
+        /* A session ends after this many hands, or sooner once the bankroll is below the minimum bet */
+        int handsPerSession = 1000;
+
+        double initialBankroll = DEFAULT_INITIAL_BANKROLL;
+
+        /* A session is ruined once its bankroll is below this, no bet is ever smaller */
+        double minimumBet = DEFAULT_MINIMUM_BET;
+
+        BetSizing sizing = BetSizing::FLAT;
+        double proportion = DEFAULT_PROPORTION;
+        double kellyMultiplier = DEFAULT_KELLY_MULTIPLIER;
+
+        /* 0 uses every hardware thread */
+        int numberOfThreads = 0;
+
+        /* Session s starts at a point of the stream drawn from substream s of the seed, so runs do not depend on the threads */
+        std::uint64_t seed = 0;
+    };
+
+    struct BankrollResult {
+        long long sessions = 0, ruinedSessions = 0;
+
+        /*  The standard error counts only the stream's non-overlapping windows of handsPerSession hands, at most the
+            number of sessions. Sessions beyond that reuse the stream's hands, so they are not independent and add no
+            information about the error. */
+        double riskOfRuin = 0.0, standardError = 0.0;
+        long long independentSessions = 0;
+
+        /* The final bankrolls at FINAL_BANKROLL_QUANTILES, and their mean */
+        std::array<double, FINAL_BANKROLL_QUANTILES.size()> finalBankrollQuantiles = {};
+        double meanFinalBankroll = 0.0;
+
+        /* The hands a ruined session lasted, 0 when no session was ruined */
+        double meanHandsToRuin = 0.0, medianHandsToRuin = 0.0;
+
+        /* The share of the bankroll the Kelly criterion bets on the stream, 0 when the policy loses on average */
+        double kellyShare = 0.0;
+
+        double seconds = 0.0;
+    };
+
+    /* Plays the policy at one seat of a table for the given number of hands and records their rewards */
+    OutcomeStream recordOutcomes(const policy::FrozenPolicy &frozenPolicy, long long numberOfHands, const table::TableConfig &config);
+
+    /*  The Kelly share of an even money bet that wins with probability p, loses with probability q and pushes otherwise,
+        (p - q) / (p + q), clamped to 0 for a losing bet */
+    double kellyShare(const OutcomeStream &stream);
+
+    /* Runs every session across the configured threads */
+    BankrollResult simulate(const OutcomeStream &stream, const BankrollConfig &config);
+}
+
+std::ostream& operator<<(std::ostream& o, const bankroll::BankrollResult &r);
+
+#endif /* BANKROLL_H */
@@ -0,0 +1,153 @@
+#include <gtest/gtest.h>
+
+#include <cmath>
+
+#include "bankroll.hpp"
+
+class BankrollTests : public testing::Test {
+    protected:
+        /* A stream repeating the given rewards until it holds the given number of hands */
+        static bankroll::OutcomeStream repeat(const std::vector<int> &rewards, int numberOfHands){
+            bankroll::OutcomeStream stream;
+            for (int hand = 0; hand < numberOfHands; ++hand){
+                int reward = rewards[hand % rewards.size()];
+                stream.rewards.push_back((std::int8_t)reward);
+                stream.wins += reward > 0;
+                stream.losses += reward < 0;
+                stream.pushes += reward == 0;
+            }
+            return stream;
+        }
+
+        bankroll::BankrollConfig config;
+};
+
+TEST_F(BankrollTests, FlatBetsOnLosingHandsRuinAtTheSameHand){
+    config.numberOfSessions = 1003;
+    config.initialBankroll = 100.0;
+    config.minimumBet = 5.0;
+
+    bankroll::BankrollResult result = bankroll::simulate(repeat({-1}, 1000), config);
+
+    EXPECT_EQ(1003, result.sessions);
+    EXPECT_EQ(1003, result.ruinedSessions);
+    EXPECT_DOUBLE_EQ(1.0, result.riskOfRuin);
+    EXPECT_DOUBLE_EQ(20.0, result.meanHandsToRuin);
+    EXPECT_DOUBLE_EQ(20.0, result.medianHandsToRuin);
+    for (double bankroll: result.finalBankrollQuantiles){
+        EXPECT_DOUBLE_EQ(0.0, bankroll);
+    }
+}
+
+TEST_F(BankrollTests, PushesLeaveEveryBankrollAlone){
+    config.numberOfSessions = 100;
+    config.sizing = bankroll::BetSizing::PROPORTIONAL;
+
+    bankroll::BankrollResult result = bankroll::simulate(repeat({0}, 50), config);
+
+    EXPECT_EQ(0, result.ruinedSessions);
+    EXPECT_DOUBLE_EQ(0.0, result.meanHandsToRuin);
+    EXPECT_DOUBLE_EQ(config.initialBankroll, result.meanFinalBankroll);
+    for (double bankroll: result.finalBankrollQuantiles){
+        EXPECT_DOUBLE_EQ(config.initialBankroll, bankroll);
+    }
+}
+
+TEST_F(BankrollTests, ProportionalBetsShrinkUntilTheMinimum){
+    config.numberOfSessions = 10;
+    config.initialBankroll = 100.0;
+    config.minimumBet = 1.0;
+    config.sizing = bankroll::BetSizing::PROPORTIONAL;
+    config.proportion = 0.5;
+
+    bankroll::BankrollResult result = bankroll::simulate(repeat({-1}, 64), config);
+
+    // Halved to 50, 25, 12.5, 6.25, 3.125, 1.5625, then the minimum bet of 1 leaves 0.5625
+    EXPECT_EQ(10, result.ruinedSessions);
+    EXPECT_DOUBLE_EQ(7.0, result.medianHandsToRuin);
+    EXPECT_DOUBLE_EQ(0.5625, result.meanFinalBankroll);
+}
+
+TEST_F(BankrollTests, KellyShareOfAnEvenMoneyBet){
+    // Wins 3 in 10, loses 2 in 10 and pushes the rest, so (0.3 - 0.2) / (0.3 + 0.2)
+    bankroll::OutcomeStream winning = repeat({1, 1, 1, -1, -1, 0, 0, 0, 0, 0}, 1000);
+    EXPECT_DOUBLE_EQ(0.2, bankroll::kellyShare(winning));
+
+    // A losing bet has no Kelly share, so Kelly sessions bet the minimum like flat ones
+    bankroll::OutcomeStream losing = repeat({1, -1, -1}, 999);
+    EXPECT_DOUBLE_EQ(0.0, bankroll::kellyShare(losing));
+
+    config.numberOfSessions = 500;
+    bankroll::BankrollResult flat = bankroll::simulate(losing, config);
+    config.sizing = bankroll::BetSizing::KELLY;
+    bankroll::BankrollResult kelly = bankroll::simulate(losing, config);
+
+    EXPECT_EQ(flat.ruinedSessions, kelly.ruinedSessions);
+    EXPECT_DOUBLE_EQ(flat.meanFinalBankroll, kelly.meanFinalBankroll);
+
+    // Growth is fastest at the Kelly share, so the median full Kelly session ends above a session betting twice that
+    config.numberOfSessions = 2000;
+    config.handsPerSession = 2000;
+    config.minimumBet = 0.01;
+    config.kellyMultiplier = 1.0;
+    bankroll::BankrollResult fullKelly = bankroll::simulate(winning, config);
+    config.kellyMultiplier = 2.0;
+    bankroll::BankrollResult doubleKelly = bankroll::simulate(winning, config);
+
+    EXPECT_GT(fullKelly.finalBankrollQuantiles[2], doubleKelly.finalBankrollQuantiles[2]);
+}
+
+TEST_F(BankrollTests, ResultsDoNotDependOnTheThreads){
+    // Sessions that are not a multiple of the threads or of SESSIONS_IN_STEP
+    config.numberOfSessions = 4321;
+    config.handsPerSession = 300;
+    config.minimumBet = 20.0;
+    config.sizing = bankroll::BetSizing::PROPORTIONAL;
+    config.proportion = 0.05;
+    config.seed = 11;
+
+    table::TableConfig tableConfig;
+    tableConfig.seed = 3;
+    bankroll::OutcomeStream stream = bankroll::recordOutcomes(policy::FrozenPolicy(), 10007, tableConfig);
+
+    config.numberOfThreads = 1;
+    bankroll::BankrollResult single = bankroll::simulate(stream, config);
+    config.numberOfThreads = 3;
+    bankroll::BankrollResult parallel = bankroll::simulate(stream, config);
+
+    EXPECT_GT(single.ruinedSessions, 0);
+    EXPECT_LT(single.ruinedSessions, single.sessions);
+
+    // The 4321 sessions overlap on a stream with room for 33 sessions of 300 hands, so the error is that of 33
+    EXPECT_EQ(10007 / 300, single.independentSessions);
+    EXPECT_DOUBLE_EQ(std::sqrt(single.riskOfRuin * (1.0 - single.riskOfRuin) / (10007 / 300)), single.standardError);
+    EXPECT_EQ(single.ruinedSessions, parallel.ruinedSessions);
+    EXPECT_DOUBLE_EQ(single.meanFinalBankroll, parallel.meanFinalBankroll);
+    EXPECT_DOUBLE_EQ(single.meanHandsToRuin, parallel.meanHandsToRuin);
+    for (std::size_t q = 0; q < bankroll::FINAL_BANKROLL_QUANTILES.size(); ++q){
+        EXPECT_DOUBLE_EQ(single.finalBankrollQuantiles[q], parallel.finalBankrollQuantiles[q]);
+    }
+}
+
+TEST_F(BankrollTests, RecordedStreamPlaysLikeTheTable){
+    /* Hits below 12 and stands everywhere else */
+    policy::FrozenPolicy standOnTwelve;
+
+    table::TableConfig tableConfig;
+    tableConfig.seed = 4;
+
+    const long long numberOfHands = 20000;
+    bankroll::OutcomeStream stream = bankroll::recordOutcomes(standOnTwelve, numberOfHands, tableConfig);
+    evaluation::RewardTally tally = table::combineSeats(table::simulate(standOnTwelve, 1, numberOfHands, tableConfig));
+
+    // The same seed deals the same shoes, so the stream holds exactly the table's hands
+    ASSERT_EQ(numberOfHands, (long long)stream.rewards.size());
+    EXPECT_EQ(numberOfHands, stream.wins + stream.losses + stream.pushes);
+
+    double rewardSum = 0.0;
+    for (std::int8_t reward: stream.rewards){
+        rewardSum += reward;
+    }
+    EXPECT_DOUBLE_EQ(tally.rewardSum, rewardSum);
+    EXPECT_DOUBLE_EQ(tally.rewardSum, (double)(stream.wins - stream.losses));
+}
@@ -0,0 +1,87 @@
+#include "blackjack_api.h"
+
+#include "trainer.hpp"
+
+struct blackjack_environment {
+    environment::EnvironmentHandler handler;
+};
+
+struct blackjack_trainer {
+    trainer::Trainer run;
+
+    explicit blackjack_trainer(const trainer::TrainerConfig &config) : run(config) {}
+};
+
+namespace {
+    blackjack_step_result toStepResult(const environment::StepResult &result){
+        blackjack_step_result converted;
+        converted.player_total = result.observation.playerTotal;
+        converted.faceup_total = result.observation.faceupTotal;
+        converted.running_count = result.observation.runningCount;
+        converted.usable_ace = result.observation.usableAce;
+        converted.reward = result.reward;
+        converted.done = result.done;
+        converted.outcome = (std::int32_t)result.outcome;
+        return converted;
+    }
+
+    /*  The environment narrates every round to cout, which a library must not do to its host's output.
+        Narration is turned off once as the library loads, so no call touches the host's streams. */
+    const bool narrationTurnedOff = (environment::setNarration(false), true);
+}
+
+blackjack_environment* blackjack_environment_create(void){
+    return new blackjack_environment();
+}
+
+void blackjack_environment_destroy(blackjack_environment *environment){
+    delete environment;
+}
+
+blackjack_step_result blackjack_environment_reset(blackjack_environment *environment, uint64_t seed, uint64_t episode){
+    return toStepResult(environment->handler.reset(seed, episode));
+}
+
+blackjack_step_result blackjack_environment_step(blackjack_environment *environment, int32_t action){
+    return toStepResult(environment->handler.step(action == BLACKJACK_HIT ? environment::Action::HIT : environment::Action::STAND));
+}
+
+blackjack_trainer* blackjack_trainer_create(uint64_t seed, float epsilon, float decay_rate){
+    trainer::TrainerConfig config;
+    config.seed = seed;
+    config.epsilon = epsilon;
+    config.decayRate = decay_rate;
+    return new blackjack_trainer(config);
+}
+
+void blackjack_trainer_destroy(blackjack_trainer *trainer){
+    delete trainer;
+}
+
+double blackjack_trainer_train(blackjack_trainer *trainer, int64_t number_of_episodes){
+    // The run carries on from its earlier calls, so training in several calls deals the same cards as one long call
+    double rewardsBefore = trainer->run.getStats().cumulativeReward;
+    trainer->run.train(number_of_episodes);
+    return trainer->run.getStats().cumulativeReward - rewardsBefore;
+}
+
+int64_t blackjack_trainer_episodes(const blackjack_trainer *trainer){
+    return trainer->run.getStats().episodesCompleted;
+}
+
+float* blackjack_trainer_q_values(blackjack_trainer *trainer, int32_t shape[4]){
+    if (shape != nullptr){
+        for (int i = 0; i < function::NUMBER_OF_DIMENSIONS; ++i){
+            shape[i] = function::FUNCTION_SHAPE[i];
+        }
+    }
+    return trainer->run.getQ().data();
+}
+
+int32_t blackjack_trainer_save(const blackjack_trainer *trainer, const char *path){
+    return trainer->run.getQ().saveToFile(path);
+}
+
+int32_t blackjack_trainer_load(blackjack_trainer *trainer, const char *path){
+    return trainer->run.getQ().loadFromFile(path);
+}
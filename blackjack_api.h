@@ -0,0 +1,82 @@
+#pragma once
+
+#ifndef BLACKJACK_API_H
+
+#define BLACKJACK_API_H
+
+/*  A C interface to the environment and to training, built into the libblackjack shared library.
+    It is meant for other languages, e.g. Python through ctypes, so only plain C types cross it.
+    Every handle is created and destroyed through this interface and must not be used across threads at once,
+    while different handles can be used from different threads. Games are never narrated to the host's output. */
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#if defined(_WIN32)
+    #define BLACKJACK_API __declspec(dllexport)
+#else
+    #define BLACKJACK_API __attribute__((visibility("default")))
+#endif
+
+/* Actions passed to blackjack_environment_step */
+#define BLACKJACK_STAND 0
+#define BLACKJACK_HIT 1
+
+typedef struct blackjack_environment blackjack_environment;
+
+typedef struct blackjack_trainer blackjack_trainer;
+
+/* The observation, reward and outcome returned by every reset and step */
+typedef struct blackjack_step_result {
+    int32_t player_total;
+    int32_t faceup_total;
+    int32_t running_count;
+    int32_t usable_ace;
+
+    /* The reward of the finished game, 0 while it is unfinished */
+    float reward;
+
+    int32_t done;
+
+    /* The GameResult value, 0 while the game is unfinished */
+    int32_t outcome;
+} blackjack_step_result;
+
+BLACKJACK_API blackjack_environment* blackjack_environment_create(void);
+
+BLACKJACK_API void blackjack_environment_destroy(blackjack_environment *environment);
+
+/* Deals a new game from the substream of the episode, so the same seed and episode always deal the same cards */
+BLACKJACK_API blackjack_step_result blackjack_environment_reset(blackjack_environment *environment, uint64_t seed, uint64_t episode);
+
+BLACKJACK_API blackjack_step_result blackjack_environment_step(blackjack_environment *environment, int32_t action);
+
+/*  A Monte Carlo control run with its own Q table and epsilon-greedy agent, the run blackjack_ai trains.
+    With an epsilon of 1 and a decay rate of 0.999 it learns the same Q table as blackjack_ai given the same seed. */
+BLACKJACK_API blackjack_trainer* blackjack_trainer_create(uint64_t seed, float epsilon, float decay_rate);
+
+BLACKJACK_API void blackjack_trainer_destroy(blackjack_trainer *trainer);
+
+/* Plays the next number_of_episodes episodes, carrying on from earlier calls, and returns their summed reward */
+BLACKJACK_API double blackjack_trainer_train(blackjack_trainer *trainer, int64_t number_of_episodes);
+
+BLACKJACK_API int64_t blackjack_trainer_episodes(const blackjack_trainer *trainer);
+
+/*  The trainer's live Q table as a contiguous row-major block of floats.
+    shape receives the extent of each of the 4 indices: player total, dealer face up total, action and usable ace.
+    The pointer stays valid, and sees every later update, until the trainer is destroyed. */
+BLACKJACK_API float* blackjack_trainer_q_values(blackjack_trainer *trainer, int32_t shape[4]);
+
+/* Writes or reads the Q table as a checkpoint, returning 1 on success and 0 otherwise */
+BLACKJACK_API int32_t blackjack_trainer_save(const blackjack_trainer *trainer, const char *path);
+
+BLACKJACK_API int32_t blackjack_trainer_load(blackjack_trainer *trainer, const char *path);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* BLACKJACK_API_H */
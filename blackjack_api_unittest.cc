@@ -0,0 +1,153 @@
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <vector>
+#include <iostream>
+
+#include "blackjack_api.h"
+
+TEST(BlackjackApiTests, ResetIsReproducibleAndStepsToTheEnd){
+    blackjack_environment *environment = blackjack_environment_create();
+
+    blackjack_step_result first = blackjack_environment_reset(environment, 9, 4);
+    blackjack_step_result repeated = blackjack_environment_reset(environment, 9, 4);
+
+    EXPECT_EQ(first.player_total, repeated.player_total);
+    EXPECT_EQ(first.faceup_total, repeated.faceup_total);
+    EXPECT_EQ(first.running_count, repeated.running_count);
+
+    blackjack_step_result result = repeated;
+    while (!result.done){
+        result = blackjack_environment_step(environment, BLACKJACK_HIT);
+    }
+    EXPECT_NE(0, result.outcome);
+
+    // A finished game stays finished
+    blackjack_step_result after = blackjack_environment_step(environment, BLACKJACK_HIT);
+    EXPECT_TRUE(after.done);
+    EXPECT_EQ(result.outcome, after.outcome);
+    EXPECT_EQ(result.reward, after.reward);
+
+    blackjack_environment_destroy(environment);
+}
+
+TEST(BlackjackApiTests, QValuesAreTheLiveTable){
+    blackjack_trainer *trainer = blackjack_trainer_create(5, 1.0f, 0.999f);
+
+    int32_t shape[4];
+    float *values = blackjack_trainer_q_values(trainer, shape);
+    EXPECT_EQ(22, shape[0]);
+    EXPECT_EQ(12, shape[1]);
+    EXPECT_EQ(2, shape[2]);
+    EXPECT_EQ(2, shape[3]);
+
+    int size = shape[0] * shape[1] * shape[2] * shape[3];
+    int nonZero = 0;
+    for (int i = 0; i < size; ++i){
+        nonZero += values[i] != 0.0f;
+    }
+    EXPECT_EQ(0, nonZero);
+
+    // The pointer taken before training sees the updates made by it
+    blackjack_trainer_train(trainer, 1000);
+    EXPECT_EQ(1000, blackjack_trainer_episodes(trainer));
+
+    for (int i = 0; i < size; ++i){
+        nonZero += values[i] != 0.0f;
+    }
+    EXPECT_GT(nonZero, 0);
+
+    blackjack_trainer_destroy(trainer);
+}
+
+TEST(BlackjackApiTests, TrainingInPartsMatchesOneCall){
+    blackjack_trainer *whole = blackjack_trainer_create(5, 1.0f, 0.999f), *parts = blackjack_trainer_create(5, 1.0f, 0.999f);
+
+    double wholeRewards = blackjack_trainer_train(whole, 2000);
+    double partRewards = blackjack_trainer_train(parts, 500) + blackjack_trainer_train(parts, 1500);
+    EXPECT_EQ(wholeRewards, partRewards);
+
+    int32_t shape[4];
+    float *wholeValues = blackjack_trainer_q_values(whole, shape), *partValues = blackjack_trainer_q_values(parts, nullptr);
+    EXPECT_EQ(
+        std::vector<float>(wholeValues, wholeValues + shape[0] * shape[1] * shape[2] * shape[3]),
+        std::vector<float>(partValues, partValues + shape[0] * shape[1] * shape[2] * shape[3])
+    );
+
+    blackjack_trainer_destroy(whole);
+    blackjack_trainer_destroy(parts);
+}
+
+TEST(BlackjackApiTests, HandlesRunOnTwoThreadsWithoutTouchingTheHostsOutput){
+    blackjack_trainer *alone = blackjack_trainer_create(7, 1.0f, 0.999f);
+    double aloneRewards = blackjack_trainer_train(alone, 3000);
+
+    blackjack_trainer *trainer = blackjack_trainer_create(7, 1.0f, 0.999f);
+    blackjack_environment *environment = blackjack_environment_create();
+
+    testing::internal::CaptureStdout();
+
+    double rewards = 0.0;
+    std::thread training([&](){
+        rewards = blackjack_trainer_train(trainer, 3000);
+    });
+
+    int finishedGames = 0;
+    std::thread stepping([&](){
+        for (uint64_t episode = 0; episode < 2000; ++episode){
+            blackjack_step_result result = blackjack_environment_reset(environment, 8, episode);
+            while (!result.done){
+                result = blackjack_environment_step(environment, result.player_total < 15 ? BLACKJACK_HIT : BLACKJACK_STAND);
+            }
+            finishedGames += result.outcome != 0;
+        }
+    });
+
+    // The host keeps writing while both handles are in use
+    for (int line = 0; line < 100; ++line){
+        std::cout << "host " << line << "\n";
+    }
+
+    training.join();
+    stepping.join();
+    std::cout << "done" << std::endl;
+
+    std::string output = testing::internal::GetCapturedStdout();
+
+    std::string expected;
+    for (int line = 0; line < 100; ++line){
+        expected += "host " + std::to_string(line) + "\n";
+    }
+    EXPECT_EQ(expected + "done\n", output);
+    EXPECT_TRUE(std::cout.good());
+
+    EXPECT_EQ(2000, finishedGames);
+    EXPECT_EQ(aloneRewards, rewards);
+
+    blackjack_trainer_destroy(alone);
+    blackjack_trainer_destroy(trainer);
+    blackjack_environment_destroy(environment);
+}
+
+TEST(BlackjackApiTests, CheckpointRoundTrips){
+    const std::string path = testing::TempDir() + "blackjack_api_unittest.bjq";
+
+    blackjack_trainer *trained = blackjack_trainer_create(3, 1.0f, 0.999f), *loaded = blackjack_trainer_create(4, 1.0f, 0.999f);
+    blackjack_trainer_train(trained, 500);
+
+    EXPECT_EQ(1, blackjack_trainer_save(trained, path.c_str()));
+    EXPECT_EQ(1, blackjack_trainer_load(loaded, path.c_str()));
+    EXPECT_EQ(0, blackjack_trainer_load(loaded, (testing::TempDir() + "missing_blackjack_api_unittest.bjq").c_str()));
+
+    int32_t shape[4];
+    float *trainedValues = blackjack_trainer_q_values(trained, shape), *loadedValues = blackjack_trainer_q_values(loaded, nullptr);
+    for (int i = 0; i < shape[0] * shape[1] * shape[2] * shape[3]; ++i){
+        EXPECT_EQ(trainedValues[i], loadedValues[i]);
+    }
+
+    blackjack_trainer_destroy(trained);
+    blackjack_trainer_destroy(loaded);
+    std::remove(path.c_str());
+}
@@ -0,0 +1,98 @@
+/*  Watches the counters a training run started with --live-stats <name> publishes, e.g.
+        blackjack_ai --live-stats overnight
+        blackjack_stats overnight
+    Reading them never blocks or slows the run, see livestats.hpp. The watcher stops when the run finishes, or
+    reports the run as stalled or gone when its publications stop, see livestats::hasStalled. */
+
+#include <chrono>
+#include <thread>
+#include <string>
+#include <cstdint>
+#include <memory>
+#include <cstdlib>
+#include <iostream>
+#include <algorithm>
+#include <unistd.h>
+
+#include "livestats.hpp"
+
+const int DEFAULT_REFRESH_INTERVAL = 1000;
+
+int main(int argc, char* argv[]){
+    std::string runName;
+    int refreshInterval = DEFAULT_REFRESH_INTERVAL;
+    bool once = false;
+
+    for (int i = 1; i < argc; ++i){
+        std::string argument = argv[i];
+
+        if (argument == "--once"){
+            once = true;
+        } else if (argument == "--interval" && i + 1 < argc){
+            refreshInterval = std::max(10, std::atoi(argv[++i]));
+        } else if (runName.empty() && argument[0] != '-'){
+            runName = argument;
+        } else {
+            runName.clear();
+            break;
+        }
+    }
+
+    if (runName.empty()){
+        std::cerr << "Usage: " << argv[0] << " <run name> [--interval milliseconds] [--once]\n";
+        return 1;
+    }
+
+    // A run that has not started yet is waited for, unless only one reading was asked for
+    std::unique_ptr<livestats::LiveStatsReader> reader(new livestats::LiveStatsReader(runName));
+    while (!reader->isOpen()){
+        if (once){
+            std::cerr << "No live statistics are published as " << livestats::segmentName(runName) << "\n";
+            return 1;
+        }
+
+        std::this_thread::sleep_for(std::chrono::milliseconds(refreshInterval));
+        reader.reset(new livestats::LiveStatsReader(runName));
+    }
+
+    // Redraw in place on a terminal, and append one reading after another anywhere else
+    bool redraw = isatty(STDOUT_FILENO) && !once;
+
+    livestats::LiveStats stats;
+    std::uint64_t publications = 0;
+    auto lastPublication = std::chrono::steady_clock::now();
+
+    for (;;){
+        if (reader->read(stats)){
+            if (redraw){
+                std::cout << "\033[H\033[2J";
+            }
+            std::cout << stats << std::endl;
+
+            if (once || !stats.running){
+                break;
+            }
+
+            // A run that is killed never clears running, so it is only noticed by its publications stopping
+            std::uint64_t latestPublications = reader->getPublications();
+            if (latestPublications != publications){
+                publications = latestPublications;
+                lastPublication = std::chrono::steady_clock::now();
+            }
+
+            double silentSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - lastPublication).count();
+            if (livestats::hasStalled(stats, silentSeconds)){
+                std::cerr << "The run has published nothing for " << (long long)silentSeconds << "s, so it has stalled or was killed.\n" <<
+                    "A killed run leaves " << livestats::segmentName(runName) << " behind until the next run named " << runName << "\n";
+                return 1;
+            }
+        } else if (once){
+            std::cerr << "The run has not published yet\n";
+            return 1;
+        }
+
+        std::this_thread::sleep_for(std::chrono::milliseconds(refreshInterval));
+    }
+
+    return 0;
+}
@@ -1,5 +1,127 @@
+import ctypes
+import os
+
 import numpy as np
 import matplotlib.pyplot as plt
 
-def plot_blackjack_values(V):
-    pass
\ No newline at end of file
+# Indices of the action axis of a Q table
+STAND, HIT = 0, 1
+
+
+class StepResult(ctypes.Structure):
+    """Mirrors blackjack_step_result in blackjack_api.h"""
+    _fields_ = [
+        ("player_total", ctypes.c_int32),
+        ("faceup_total", ctypes.c_int32),
+        ("running_count", ctypes.c_int32),
+        ("usable_ace", ctypes.c_int32),
+        ("reward", ctypes.c_float),
+        ("done", ctypes.c_int32),
+        ("outcome", ctypes.c_int32),
+    ]
+
+
+def load_library(path=None):
+    """Loads libblackjack, by default from the build directory next to this one"""
+    if path is None:
+        path = os.path.join(os.path.dirname(os.path.abspath(__file__)), "..", "build", "libblackjack.so")
+
+    library = ctypes.CDLL(path)
+
+    library.blackjack_environment_create.restype = ctypes.c_void_p
+    library.blackjack_environment_destroy.argtypes = [ctypes.c_void_p]
+    library.blackjack_environment_reset.argtypes = [ctypes.c_void_p, ctypes.c_uint64, ctypes.c_uint64]
+    library.blackjack_environment_reset.restype = StepResult
+    library.blackjack_environment_step.argtypes = [ctypes.c_void_p, ctypes.c_int32]
+    library.blackjack_environment_step.restype = StepResult
+
+    library.blackjack_trainer_create.argtypes = [ctypes.c_uint64, ctypes.c_float, ctypes.c_float]
+    library.blackjack_trainer_create.restype = ctypes.c_void_p
+    library.blackjack_trainer_destroy.argtypes = [ctypes.c_void_p]
+    library.blackjack_trainer_train.argtypes = [ctypes.c_void_p, ctypes.c_int64]
+    library.blackjack_trainer_train.restype = ctypes.c_double
+    library.blackjack_trainer_episodes.argtypes = [ctypes.c_void_p]
+    library.blackjack_trainer_episodes.restype = ctypes.c_int64
+    library.blackjack_trainer_q_values.argtypes = [ctypes.c_void_p, ctypes.POINTER(ctypes.c_int32)]
+    library.blackjack_trainer_q_values.restype = ctypes.POINTER(ctypes.c_float)
+    library.blackjack_trainer_save.argtypes = [ctypes.c_void_p, ctypes.c_char_p]
+    library.blackjack_trainer_save.restype = ctypes.c_int32
+    library.blackjack_trainer_load.argtypes = [ctypes.c_void_p, ctypes.c_char_p]
+    library.blackjack_trainer_load.restype = ctypes.c_int32
+
+    return library
+
+
+class Environment:
+    """A single game, reset to the cards of an episode of a seed and stepped with STAND or HIT"""
+
+    def __init__(self, library):
+        self.library = library
+        self.handle = library.blackjack_environment_create()
+
+    def reset(self, seed, episode=0):
+        return self.library.blackjack_environment_reset(self.handle, seed, episode)
+
+    def step(self, action):
+        return self.library.blackjack_environment_step(self.handle, action)
+
+    def __del__(self):
+        self.library.blackjack_environment_destroy(self.handle)
+
+
+class Trainer:
+    """Monte Carlo control with an epsilon-greedy agent, whose Q table can be read while it trains"""
+
+    def __init__(self, library, seed=0, epsilon=1.0, decay_rate=0.999):
+        self.library = library
+        self.handle = library.blackjack_trainer_create(seed, epsilon, decay_rate)
+
+    def train(self, number_of_episodes):
+        """Returns the summed reward of the episodes"""
+        return self.library.blackjack_trainer_train(self.handle, number_of_episodes)
+
+    @property
+    def episodes(self):
+        return self.library.blackjack_trainer_episodes(self.handle)
+
+    def q_values(self):
+        """The live Q table indexed by [player total, dealer face up total, action, usable ace].
+        The array shares the trainer's memory, so it is never copied and sees every later update,
+        but it must not be used after the trainer is gone."""
+        shape = (ctypes.c_int32 * 4)()
+        values = self.library.blackjack_trainer_q_values(self.handle, shape)
+        return np.ctypeslib.as_array(values, shape=tuple(shape))
+
+    def save(self, path):
+        return bool(self.library.blackjack_trainer_save(self.handle, path.encode()))
+
+    def load(self, path):
+        return bool(self.library.blackjack_trainer_load(self.handle, path.encode()))
+
+    def __del__(self):
+        self.library.blackjack_trainer_destroy(self.handle)
+
+
+def plot_blackjack_values(Q):
+    """Plots the value of the greedy action in each state that needs a decision, with and without a usable ace"""
+    V = Q.max(axis=2)[12:22, 2:12]
+
+    figure, axes = plt.subplots(1, 2, figsize=(12, 5))
+    for usable_ace, axis in enumerate(axes):
+        image = axis.imshow(V[:, :, usable_ace], origin="lower", extent=[1.5, 11.5, 11.5, 21.5], cmap="coolwarm")
+        axis.set_title("Usable ace" if usable_ace else "No usable ace")
+        axis.set_xlabel("Dealer face up total")
+        axis.set_ylabel("Player total")
+        figure.colorbar(image, ax=axis)
+
+    plt.show()
+
+
+if __name__ == "__main__":
+    trainer = Trainer(load_library(), seed=0)
+    Q = trainer.q_values()
+
+    trainer.train(500000)
+
+    # Q already holds the trained values, nothing was written to or read from a file
+    plot_blackjack_values(Q)
@@ -1,21 +1,98 @@
 #include "environment.hpp"
 
+#include <atomic>
 #include <string>
+#include <fstream>
+#include <algorithm>
+
+#include "profiler.hpp"
 
 using std::cout;
 using std::vector;
 // using namespace environment;
 // using namespace game_assets;
 
+namespace {
+    /* Whether games are narrated, a process-wide setting rather than per environment since narration goes to cout */
+    std::atomic<bool> narrationEnabled(true);
+
+    /* Drops every character, which the base class already does when nothing overrides it */
+    class DiscardingBuffer : public std::streambuf {};
+
+    /*  Failed from the start, so writing to it neither formats anything nor changes its state, from any thread.
+        A null buffer would not do, since a write to a bad stream sets its failbit again. */
+    class SilentStream : public std::ostream {
+    public:
+        SilentStream() : std::ostream(&buffer) {
+            setstate(std::ios_base::failbit);
+        }
+
+    private:
+        DiscardingBuffer buffer;
+    };
+
+    /* The SplitMix64 finaliser, a bijective mix in which every input bit affects every output bit */
+    inline std::uint64_t mix64(std::uint64_t z) {
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+        return z ^ (z >> 31);
+    }
+}
+
+environment::RandomEngine::RandomEngine(std::uint64_t seed, std::uint64_t stream) {
+    this->seed(seed, stream);
+}
+
+void environment::RandomEngine::seed(std::uint64_t seed, std::uint64_t stream) {
+    // Mixing twice keeps neighbouring seeds and neighbouring streams from giving related keys
+    key = mix64(mix64(seed) + stream * 0xD1B54A32D192ED03ull);
+    counter = 0;
+}
+
+void environment::RandomEngine::discard(unsigned long long n) {
+    counter += n;
+}
+
+environment::RandomEngine::result_type environment::RandomEngine::operator()() {
+    return (result_type)(mix64(key + (counter++) * 0x9E3779B97F4A7C15ull) >> 32);
+}
+
+environment::RandomEngine& environment::randomEngine() {
+    thread_local RandomEngine engine((std::uint64_t)rand());
+    return engine;
+}
+
+void environment::seedEpisode(std::uint64_t seed, std::uint64_t episode) {
+    randomEngine().seed(seed, episode);
+}
+
+void environment::setNarration(bool enabled) {
+    narrationEnabled.store(enabled, std::memory_order_relaxed);
+}
+
+std::ostream& environment::narration() {
+    static SilentStream silent;
+    return narrationEnabled.load(std::memory_order_relaxed) ? cout : silent;
+}
+
+float environment::generateRewardValue(environment::GameResult outcome){
+    if (outcome == environment::GameResult::PLAYER_WIN){ // Win
+        return 1.0f;
+    } else if (outcome == environment::GameResult::DEALER_WIN){ // Loss
+        return -1.0f;
+    } else { // Draw
+        return 0.0f;
+    }
+}
+
 environment::GameState::GameState() :
     playerTotal(0), dealerTotal(0), faceupTotal(0),
-    numberOfDeals(0), numberOfSeenCards(0),
+    numberOfDeals(0), numberOfSeenCards(0), runningCount(0),
     dealerShowsAll(false),
     playerHasUsableAce(false),
     dealerHasUsableAce(false),
     outcome(GameResult::UNFINISHED) {
-        playerCards.reserve(60), dealerCards.reserve(60);
-        playerCards.resize(52, 0), dealerCards.resize(52, 0);
+        playerCards.fill(0), dealerCards.fill(0);
 }
 
 bool environment::GameState::doesPlayerHaveUsableAce() const {
@@ -26,6 +103,10 @@ bool environment::GameState::doesDealerHaveUsableAce() const {
     return dealerHasUsableAce;
 }
 
+int environment::GameState::getRunningCount() const {
+    return runningCount;
+}
+
 void environment::GameState::updateTotal(
     int cardValue,
     int &total,
@@ -49,6 +130,8 @@ void environment::GameState::updateTotal(
 }
 
 void environment::GameState::addCard(game_assets::Card card, bool forPlayer) {
+    PROFILE_SCOPE(profiler::Phase::STATE_UPDATE);
+
     int cardID = card.getID();
 
     // If seen the card was seen do not add it again
@@ -58,6 +141,12 @@ void environment::GameState::addCard(game_assets::Card card, bool forPlayer) {
 
     int cardValue = (int)card.getValue();
 
+    // Only cards the player can see contribute to the count, so the dealer's face down card is skipped
+    if (forPlayer || faceupTotal == 0 || dealerShowsAll) {
+        // Hi-Lo: low cards (2-6) count +1, tens and aces count -1
+        runningCount += (cardValue >= 2 && cardValue <= 6) - (cardValue == 10 || cardValue == 1);
+    }
+
     // Give card to the appropriate owner
     if (forPlayer) {
         playerCards[cardID] = 1;
@@ -107,11 +196,11 @@ std::vector<int> environment::GameState::getSeenCards() const{
 }
 
 std::vector<int> environment::GameState::getPlayerCards() const{
-    return playerCards;
+    return std::vector<int>(playerCards.begin(), playerCards.end());
 }
 
 std::vector<int> environment::GameState::getDealerCards() const{
-    return dealerCards;
+    return std::vector<int>(dealerCards.begin(), dealerCards.end());
 }
 
 void environment::GameState::setOutcome(GameResult outcome) {
@@ -194,7 +283,7 @@ void environment::GameState::showDealerCards(){
 }
 
 /* Shows if dealer is showing all the cards */ 
-bool environment::GameState::dealerCardsShown(){
+bool environment::GameState::dealerCardsShown() const {
     return this->dealerShowsAll;
 }
 
@@ -206,18 +295,247 @@ bool environment::GameState::operator==(GameState comparedState) {
     );
 }
 
-environment::EnvironmentHandler::EnvironmentHandler() {
+environment::CardStream::CardStream() : numberOfHands(0), packedCards(1, 0) {}
+
+environment::CardStream environment::CardStream::record(long long numberOfHands, std::uint64_t seed) {
+    CardStream stream;
+    stream.packedCards.reserve((std::size_t)numberOfHands * BYTES_PER_RECORDED_HAND + 1);
+
+    std::array<int, game_assets::DECK_SIZE> deckOrder;
+    std::array<int, MAX_CARDS_PER_HAND> cardIDs;
+    RandomEngine engine;
+
+    for (long long hand = 0; hand < numberOfHands; ++hand) {
+        // Every hand starts from an ordered deck so it only depends on its own substream
+        for (int i = 0; i < game_assets::DECK_SIZE; ++i) {
+            deckOrder[i] = i;
+        }
+        engine.seed(seed, (std::uint64_t)hand);
+
+        // Only the cards a hand can reach need to be shuffled into place
+        for (int i = 0; i < MAX_CARDS_PER_HAND; ++i) {
+            int j = i + (int)(engine() % (RandomEngine::result_type)(game_assets::DECK_SIZE - i));
+            std::swap(deckOrder[i], deckOrder[j]);
+            cardIDs[i] = deckOrder[i];
+        }
+
+        stream.appendHand(cardIDs);
+    }
+
+    return stream;
+}
+
+void environment::CardStream::appendHand(const std::array<int, MAX_CARDS_PER_HAND> &cardIDs) {
+    // Drop the padding byte, then add the hand and a new padding byte
+    packedCards.pop_back();
+    std::size_t start = packedCards.size();
+    packedCards.resize(start + BYTES_PER_RECORDED_HAND + 1, 0);
+
+    for (int i = 0; i < MAX_CARDS_PER_HAND; ++i) {
+        std::size_t bit = (std::size_t)i * CARD_ID_BITS;
+        unsigned int shifted = (unsigned int)cardIDs[i] << (bit % 8);
+
+        packedCards[start + bit / 8] |= (std::uint8_t)shifted;
+        packedCards[start + bit / 8 + 1] |= (std::uint8_t)(shifted >> 8);
+    }
+
+    ++numberOfHands;
+}
+
+int environment::CardStream::getCard(long long hand, int position) const {
+    std::size_t bit = (std::size_t)hand * BYTES_PER_RECORDED_HAND * 8 + (std::size_t)position * CARD_ID_BITS;
+
+    // A card can straddle two bytes, the padding byte makes the second read safe for the last card
+    unsigned int word = packedCards[bit / 8] | (unsigned int)packedCards[bit / 8 + 1] << 8;
+
+    return (int)((word >> (bit % 8)) & ((1u << CARD_ID_BITS) - 1));
+}
+
+long long environment::CardStream::getNumberOfHands() const {
+    return numberOfHands;
+}
+
+bool environment::CardStream::saveToFile(const std::string &path) const {
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+
+    file.write("BJCS", 4);
+    file.write(reinterpret_cast<const char*>(&numberOfHands), sizeof(numberOfHands));
+    file.write(reinterpret_cast<const char*>(packedCards.data()), (std::streamsize)packedCards.size());
+
+    return (bool)file;
+}
+
+bool environment::CardStream::loadFromFile(const std::string &path) {
+    std::ifstream file(path, std::ios::binary);
+
+    char magic[4];
+    long long hands = 0;
+    file.read(magic, sizeof(magic));
+    file.read(reinterpret_cast<char*>(&hands), sizeof(hands));
+
+    if (!file || std::string(magic, sizeof(magic)) != "BJCS" || hands < 0) {
+        return false;
+    }
+
+    std::vector<std::uint8_t> loaded((std::size_t)hands * BYTES_PER_RECORDED_HAND + 1);
+    file.read(reinterpret_cast<char*>(loaded.data()), (std::streamsize)loaded.size());
+
+    if (!file) {
+        return false;
+    }
+
+    numberOfHands = hands;
+    packedCards.swap(loaded);
+    return true;
+}
+
+environment::EnvironmentHandler::EnvironmentHandler() : cardStream(nullptr), streamHand(0), steppingMode(SteppingMode::EVERY_ROUND) {
+    reset();
+}
+
+environment::EnvironmentHandler::EnvironmentHandler(const CardStream &cardStream, long long hand)
+    : steppingMode(SteppingMode::EVERY_ROUND) {
+    reset(cardStream, hand);
+}
+
+environment::StepResult environment::EnvironmentHandler::reset() {
+    currentState = GameState();
     numberOfRemainingCards = game_assets::DECK_SIZE;
+    seenIDs = 0;
+    streamPosition = 0;
 
     // Start the game with the initial player action being hit
     simulateNextRound(environment::Action::HIT);
+    advanceToDecision();
+
+    return observe();
+}
+
+environment::StepResult environment::EnvironmentHandler::reset(std::uint64_t seed, std::uint64_t episode) {
+    seedEpisode(seed, episode);
+    cardStream = nullptr;
+    return reset();
+}
+
+environment::StepResult environment::EnvironmentHandler::reset(const CardStream &cardStream, long long hand) {
+    this->cardStream = &cardStream;
+    streamHand = hand;
+    return reset();
+}
+
+environment::StepResult environment::EnvironmentHandler::resetToState(int playerTotal, int faceupTotal, bool usableAce) {
+    static const game_assets::Deck deck;
+
+    currentState = GameState();
+    numberOfRemainingCards = game_assets::DECK_SIZE;
+    seenIDs = 0;
+    cardStream = nullptr;
+    streamPosition = 0;
+
+    playerTotal = std::max(12, std::min(playerTotal, MAX_PLAYER_TOTAL));
+    faceupTotal = std::max(2, std::min(faceupTotal, MAX_DEALER_SHOWING));
+
+    if (usableAce) {
+        // The ace counts 11, so the other card makes up the rest, a second ace counting 1 in a soft 12
+        currentState.addCard(deck[selectCardOfValue(1)], true);
+        currentState.addCard(deck[selectCardOfValue(playerTotal - 11)], true);
+    } else {
+        // Two cards of 2 to 10 reach any hard total up to 20 and three reach 21, so no value is needed five times
+        int remaining = playerTotal;
+        for (int cardsLeft = playerTotal <= 20 ? 2 : 3; cardsLeft > 0; --cardsLeft) {
+            int lowest = std::max(2, remaining - 10 * (cardsLeft - 1)), highest = std::min(10, remaining - 2 * (cardsLeft - 1));
+            int value = cardsLeft == 1
+                ? remaining
+                : lowest + (int)(randomEngine()() % (RandomEngine::result_type)(highest - lowest + 1));
+
+            currentState.addCard(deck[selectCardOfValue(value)], true);
+            remaining -= value;
+        }
+    }
+
+    // The first dealer card is the one left face up
+    currentState.addCard(deck[selectCardOfValue(faceupTotal == 11 ? 1 : faceupTotal)], false);
+    currentState.addCard(deck[selectOutOfRemainingCards()], false);
+
+    currentState.setOutcome(checkGameResult());
+    ++currentState.numberOfDeals;
+
+    advanceToDecision();
+
+    return observe();
+}
+
+environment::StepResult environment::EnvironmentHandler::step(Action action) {
+    if (currentState.getOutcome() == GameResult::UNFINISHED) {
+        simulateNextRound(action);
+        advanceToDecision();
+    }
+    return observe();
+}
+
+void environment::EnvironmentHandler::setSteppingMode(SteppingMode mode) {
+    steppingMode = mode;
+}
+
+environment::SteppingMode environment::EnvironmentHandler::getSteppingMode() const {
+    return steppingMode;
+}
+
+void environment::EnvironmentHandler::advanceToDecision() {
+    if (steppingMode != SteppingMode::DECISION_POINTS) {
+        return;
+    }
+
+    // After a stand only the dealer draws, whatever action is passed, and below 12 the player always hits
+    while (currentState.getOutcome() == GameResult::UNFINISHED &&
+        (currentState.dealerCardsShown() || currentState.getPlayerTotal() < 12)) {
+        simulateNextRound(currentState.dealerCardsShown() ? Action::STAND : Action::HIT);
+    }
+}
+
+environment::StepResult environment::EnvironmentHandler::observe() const {
+    StepResult result;
+    result.observation.playerTotal = currentState.getPlayerTotal();
+    result.observation.faceupTotal = currentState.getFaceupTotal();
+    result.observation.runningCount = currentState.getRunningCount();
+    result.observation.usableAce = currentState.doesPlayerHaveUsableAce();
+
+    result.outcome = currentState.getOutcome();
+    result.done = result.outcome != GameResult::UNFINISHED;
+    result.reward = result.done ? generateRewardValue(result.outcome) : 0.0f;
+    return result;
+}
+
+int environment::EnvironmentHandler::selectCardOfValue(int value) {
+    int candidates[game_assets::DECK_SIZE], numberOfCandidates = 0;
+
+    for (int i = 0; i < game_assets::DECK_SIZE; ++i) {
+        if (!(seenIDs & ((std::uint64_t)1 << i)) && std::min(10, 1 + i % 13) == value) {
+            candidates[numberOfCandidates++] = i;
+        }
+    }
+
+    int cardID = candidates[randomEngine()() % (RandomEngine::result_type)numberOfCandidates];
+    --numberOfRemainingCards;
+    seenIDs |= (std::uint64_t)1 << cardID;
+    return cardID;
 }
 
 /* Selects a card that has not been seen yet */
 int environment::EnvironmentHandler::selectOutOfRemainingCards() {
-    cout << "\nA card is being randomly selected out of the " << numberOfRemainingCards << " remaining.\n";
+    PROFILE_SCOPE(profiler::Phase::DEAL);
+
+    // A replayed hand takes the next recorded card, which can never have been seen within the hand
+    if (cardStream != nullptr && streamPosition < MAX_CARDS_PER_HAND) {
+        int cardID = cardStream->getCard(streamHand, streamPosition++);
+        --numberOfRemainingCards;
+        seenIDs |= (std::uint64_t)1 << cardID;
+        return cardID;
+    }
+
+    narration() << "\nA card is being randomly selected out of the " << numberOfRemainingCards << " remaining.\n";
     // Choose an index out of the remaining cards to select
-    int index = rand() % numberOfRemainingCards;
+    int index = (int)(randomEngine()() % (RandomEngine::result_type)numberOfRemainingCards);
 
     // Utility function to output numbers in a correct human-readable format
     auto getNumberSuffix = [](int i){
@@ -232,20 +550,20 @@ int environment::EnvironmentHandler::selectOutOfRemainingCards() {
                 return "th";
         }
     };
-    cout << "The " << index << getNumberSuffix(index) << " unseen card out of those remaining will be selected.\n";
+    narration() << "The " << index << getNumberSuffix(index) << " unseen card out of those remaining will be selected.\n";
     // Search for the chosen index
-    cout << "Enterring selection loop\n";
+    narration() << "Enterring selection loop\n";
 
     for (int i = 0; i < game_assets::DECK_SIZE; ++i) {
         // If the current card has been seen skip it
-        if (seenIDs.find(i) != seenIDs.end()) {
+        if (seenIDs & ((std::uint64_t)1 << i)) {
             continue;
         }
 
         if (index <= 0) {
             --numberOfRemainingCards;
-            cout << "The " << i << getNumberSuffix(i) << "card in the deck was chosen";
-            seenIDs.emplace(i);
+            narration() << "The " << i << getNumberSuffix(i) << "card in the deck was chosen";
+            seenIDs |= (std::uint64_t)1 << i;
             return i;
         }
         // Decrease the index so it can be found in the next iteration
@@ -256,10 +574,10 @@ int environment::EnvironmentHandler::selectOutOfRemainingCards() {
 }
 
 /* Generates the required number of cards for the current game state */
-vector<game_assets::Card> environment::EnvironmentHandler::getNextHand() {
-    game_assets::Deck deck;
-    vector<game_assets::Card> cardsDealt;
-    vector<int> indicesChosen;
+environment::Deal environment::EnvironmentHandler::getNextHand() {
+    // The deck never changes, so it is only built once
+    static const game_assets::Deck deck;
+    Deal cardsDealt;
 
     // If this is the first deal then 4 cards are chosen; 2 for the dealer and 2 for the player
     // Otherwise 2 cards are chosen with one card for the dealer and one card for the player
@@ -277,30 +595,33 @@ vector<game_assets::Card> environment::EnvironmentHandler::getNextHand() {
     }
 
     // Select some number of cards randomly
-    int currentIndex;
+    cardsDealt.numberOfCards = numberOfCards;
     for (int i = 0; i < numberOfCards; ++i) {
-        currentIndex = selectOutOfRemainingCards();
-
-        cardsDealt.emplace_back(deck[currentIndex]);
+        cardsDealt.cards[i] = deck[selectOutOfRemainingCards()];
     }
 
     return cardsDealt;
 }
 
-void environment::EnvironmentHandler::updateTotals(vector<game_assets::Card> cardsDealt, int numberOfCards) {
+void environment::EnvironmentHandler::updateTotals(const Deal &cardsDealt) {
+    // Nothing was dealt, so there is nothing to update sums with
+    if (cardsDealt.numberOfCards == 0) {
+        return;
+    }
+
     // If on the first hand then all sums are updated
     if (currentState.numberOfDeals == 0) {
-        for (int i = 0; i < numberOfCards; ++i) {
+        for (int i = 0; i < cardsDealt.numberOfCards; ++i) {
             // The dealer takes the cards on odd turns and the player on even turns
-            currentState.addCard(cardsDealt[i], i % 2 == 0);
+            currentState.addCard(cardsDealt.cards[i], i % 2 == 0);
         }
     // If the dealer still has a card facing down then the player is still hitting
     } else if (!currentState.dealerCardsShown()) { 
         // While the player chooses to hit, only the player will be served
-        currentState.addCard(cardsDealt[0], true);
+        currentState.addCard(cardsDealt.cards[0], true);
     } else if (currentState.getDealerTotal() < 17) {
         // When only the dealer is able to hit
-        currentState.addCard(cardsDealt[0], false);
+        currentState.addCard(cardsDealt.cards[0], false);
     } else {
         // Neither the dealer or player chose or were able to hit so nothing to update sums with
         return;
@@ -308,9 +629,11 @@ void environment::EnvironmentHandler::updateTotals(vector<game_assets::Card> car
 }
 
 environment::GameResult environment::EnvironmentHandler::checkGameResult() {
+    PROFILE_SCOPE(profiler::Phase::RESULT_CHECK);
+
     // If the dealer and player can still play, then the game has not reached an end state
     if (!currentState.dealerCardsShown() && currentState.getPlayerTotal() <= 21 && currentState.getDealerTotal() < 17) {
-        cout << "\nPlayer says hit, Player hasn't bust yet and Dealer below 17; so the game continues.\n\n";
+        narration() << "\nPlayer says hit, Player hasn't bust yet and Dealer below 17; so the game continues.\n\n";
         return environment::GameResult::UNFINISHED;
     }
 
@@ -326,7 +649,7 @@ environment::GameResult environment::EnvironmentHandler::checkGameResult() {
 
         // If the player chose to hit or the dealer must still hit then carry on
     } else if (!currentState.dealerCardsShown() || currentState.getDealerTotal() < 17) {
-        cout << "\n" << "Player chose to hit (" << (!currentState.dealerCardsShown() ? "True" : "False") <<
+        narration() << "\n" << "Player chose to hit (" << (!currentState.dealerCardsShown() ? "True" : "False") <<
             ") OR Dealer below 17(" << (currentState.getDealerTotal() < 17 ? "True" : "False") << "), so game continues \n\n";
             
         return environment::GameResult::UNFINISHED;
@@ -351,20 +674,24 @@ environment::GameResult environment::EnvironmentHandler::simulateNextRound(envir
     }
 
     // Get the next hand
-    vector<game_assets::Card> cardsDealt = getNextHand();
+    Deal cardsDealt = getNextHand();
 
     // Update the totals using the cards dealt
-    updateTotals(cardsDealt, (int)cardsDealt.size());
+    updateTotals(cardsDealt);
 
     // Determine the current game state and return it
     environment::GameResult gameResult = checkGameResult();
 
     currentState.setOutcome(gameResult);
 
-    cout << currentState;
-    cout << "Current outcome: " << currentState.getOutcome() << "\n";
-    cout << "The PLAYER has a usable ace = " << (currentState.doesPlayerHaveUsableAce() ? "TRUE":"FALSE") << "\n";
-    cout << "The DEALER has a usable ace = " << (currentState.doesDealerHaveUsableAce() ? "TRUE":"FALSE") << "\n\n";
+    // Only build the printout of the state when output has not been disabled
+    std::ostream &narrated = narration();
+    if (narrated) {
+        narrated << currentState;
+        narrated << "Current outcome: " << currentState.getOutcome() << "\n";
+        narrated << "The PLAYER has a usable ace = " << (currentState.doesPlayerHaveUsableAce() ? "TRUE":"FALSE") << "\n";
+        narrated << "The DEALER has a usable ace = " << (currentState.doesDealerHaveUsableAce() ? "TRUE":"FALSE") << "\n\n";
+    }
     ++currentState.numberOfDeals;
     return gameResult;
 }
@@ -373,8 +700,17 @@ environment::GameState environment::EnvironmentHandler::getCurrentState() const{
     return this->currentState;
 }
 
+const environment::GameState& environment::EnvironmentHandler::getState() const{
+    return this->currentState;
+}
+
 std::ostream& operator<<(std::ostream& o, environment::GameState s) {
-    cout << "GameState :{\n" <<
+    // Building the card strings allocates, so skip it entirely when output is disabled
+    if (!o) {
+        return o;
+    }
+
+    o << "GameState :{\n" <<
         "  Player Total = " << s.getPlayerTotal() << "\n" <<
         "  Dealer Total (currently shown) = " << s.getFaceupTotal() << "\n" << 
         s.stringifyCards() << "}\n\n";
@@ -384,31 +720,31 @@ std::ostream& operator<<(std::ostream& o, environment::GameState s) {
 std::ostream& operator<<(std::ostream& o, environment::GameResult r) {
     switch (r) {
         case environment::GameResult::DEALER_WIN:
-            cout << "The Dealer won\n";
+            o << "The Dealer won\n";
             break;
         case environment::GameResult::MUTUAL_BUST:
-            cout << "Player and Dealer busted\n";
+            o << "Player and Dealer busted\n";
             break;
         case environment::GameResult::UNFINISHED:
-            cout << "The game is unfinished\n";
+            o << "The game is unfinished\n";
             break;
         case environment::GameResult::PUSH:
-            cout << "Equal non-bust score\n";
+            o << "Equal non-bust score\n";
             break;
         case environment::GameResult::PLAYER_WIN:
-            cout << "The Player won\n";
+            o << "The Player won\n";
             break;
         default:
-            cout << "GameResult undefined\n";
+            o << "GameResult undefined\n";
     }
     return o;
 }
 
 std::ostream& operator<<(std::ostream& o, environment::Action a) {
     if (a == environment::Action::HIT){
-        cout << "HIT" << "\n";
+        o << "HIT" << "\n";
     } else {
-        cout << "STAND" << "\n";
+        o << "STAND" << "\n";
     }
     return o;
 }
\ No newline at end of file
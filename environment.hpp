@@ -5,18 +5,60 @@
 #define ENVIRONMENT_H
 
 #include <set>
+#include <string>
 #include <vector>
+#include <cstdint>
 #include <cstdlib>
 #include <iostream>
 #include <algorithm>
-#include <unordered_set>
 #include "game_assets.hpp"
 
 namespace environment {
     const int MAX_PLAYER_TOTAL = 21, MAX_DEALER_SHOWING = 11, MAX_POSSIBLE_ACTIONS = 2, MAX_ACE_VALUE = 1;
 
+    /*  The counter-based generator used for dealing and for agent decisions.
+        The nth output of a stream is a hash of the stream's key and n, so any (seed, stream) pair
+        is an independent substream that can be started, or jumped ahead, without generating the outputs before it. */
+    class RandomEngine {
+    public:
+        using result_type = std::uint32_t;
+
+        RandomEngine(std::uint64_t seed = 0, std::uint64_t stream = 0);
+
+        /* Restarts the generator at the beginning of a substream */
+        void seed(std::uint64_t seed, std::uint64_t stream);
+
+        /* Jumps ahead n outputs in constant time */
+        void discard(unsigned long long n);
+
+        static constexpr result_type min() { return 0; }
+
+        static constexpr result_type max() { return 0xFFFFFFFFu; }
+
+        result_type operator()();
+
+    private:
+        std::uint64_t key, counter;
+    };
+
+    /*  Returns the calling thread's generator, so parallel simulations never share or lock a stream.
+        Until seedEpisode is called the generator is seeded from rand(), so srand still seeds a run. */
+    RandomEngine& randomEngine();
+
+    /*  Points the calling thread's generator at the substream of an episode.
+        Calling this at the start of every episode with the episode's index makes a run depend only on
+        its seed, not on how its episodes are spread across threads. */
+    void seedEpisode(std::uint64_t seed, std::uint64_t episode);
+
+    /*  Turns the narration of every game on or off for the whole process, on by default.
+        A failed cout still silences narration while it is on, which is how a run turns it off for a stretch. */
+    void setNarration(bool enabled);
+
+    /* The stream games are narrated to, cout while narration is on and a failed stream that discards everything while it is off */
+    std::ostream& narration();
+
     inline float getRandomFloat() {
-        return (float)(rand()) / (float)(RAND_MAX);
+        return (float)(randomEngine()() - RandomEngine::min()) / (float)(RandomEngine::max() - RandomEngine::min());
     }
 
     /*  The GameResult determines the reward the agent receives
@@ -30,6 +72,9 @@ namespace environment {
         PLAYER_WIN = 2       // Player won
     };
 
+    /* Extracts the game outcome and determines the reward value, 1 for a win, -1 for a loss and 0 otherwise */
+    float generateRewardValue(GameResult outcome);
+
     /* The possible actions an agent can make */
     enum class Action: bool{
         STAND = false,
@@ -72,12 +117,15 @@ namespace environment {
         void showDealerCards();
 
         /* Check if the dealers cards are shown */
-        bool dealerCardsShown();
+        bool dealerCardsShown() const;
 
         bool doesPlayerHaveUsableAce() const;
 
         bool doesDealerHaveUsableAce() const;
 
+        /* Hi-Lo running count of the cards visible to the player (their own cards and the dealer's face up card) */
+        int getRunningCount() const;
+
         void updateTotal(int cardValue, int &total, bool &usableAce);
 
         /* Allows the pretty printing of currently stored cards */
@@ -86,23 +134,129 @@ namespace environment {
         bool operator==(GameState comparedState);
 
     private:
-        std::vector<int> playerCards, dealerCards;
-        int playerTotal, dealerTotal, faceupTotal, numberOfSeenCards;
+        /* Fixed size so copying a state never allocates, a 1 marks a card held by its owner */
+        std::array<int, game_assets::DECK_SIZE> playerCards, dealerCards;
+        int playerTotal, dealerTotal, faceupTotal, numberOfSeenCards, runningCount;
         bool dealerShowsAll, playerHasUsableAce, dealerHasUsableAce;
         GameResult outcome;
     };
 
+    /*  The most cards a single hand can use from one deck. The player can hold at most 12 cards before busting,
+        and when they stand the player's and dealer's cards before the dealer's last one sum to at most 37,
+        which takes at most 15 of the smallest cards, so no hand can deal more than 16. */
+    const int MAX_CARDS_PER_HAND = 16;
+
+    /* Every card ID fits in 6 bits, so a recorded hand takes 12 bytes */
+    const int CARD_ID_BITS = 6;
+    const int BYTES_PER_RECORDED_HAND = MAX_CARDS_PER_HAND * CARD_ID_BITS / 8;
+
+    /*  A recorded sequence of hands, each stored as the first MAX_CARDS_PER_HAND cards of a shuffled deck.
+        Replaying a stream deals every agent the same cards in the same order, however many cards
+        each one takes, so policies can be compared on common random numbers. */
+    class CardStream {
+    public:
+        CardStream();
+
+        /* Shuffles and records the given number of hands, hand h being shuffled with substream h of the seed */
+        static CardStream record(long long numberOfHands, std::uint64_t seed);
+
+        /* Appends a hand, given as the IDs of the cards in the order they are dealt */
+        void appendHand(const std::array<int, MAX_CARDS_PER_HAND> &cardIDs);
+
+        /* The ID of the card dealt at a position of a recorded hand */
+        int getCard(long long hand, int position) const;
+
+        long long getNumberOfHands() const;
+
+        bool saveToFile(const std::string &path) const;
+
+        /* Returns false, leaving the stream untouched, if the file is missing or not a card stream */
+        bool loadFromFile(const std::string &path);
+
+    private:
+        long long numberOfHands;
+
+        /* The 6 bit card IDs of every hand back to back, with one byte of padding at the end */
+        std::vector<std::uint8_t> packedCards;
+    };
+
+    /* The opening deal gives 2 cards each to the player and dealer, every later round deals at most 1 */
+    const int MAX_CARDS_PER_DEAL = 4;
+
+    /* The cards dealt in a single round */
+    struct Deal {
+        std::array<game_assets::Card, MAX_CARDS_PER_DEAL> cards;
+        int numberOfCards;
+    };
+
+    /* How far the environment plays on each step */
+    enum class SteppingMode :int {
+        EVERY_ROUND = 0,    // Deals at most one card per step, so the agent is asked about every round
+        DECISION_POINTS     // Plays the rounds no agent decides internally, so a step stops at a real decision or the end
+    };
+
+    /* The features of a state an agent decides on, small enough to return by value on every step */
+    struct Observation {
+        int playerTotal, faceupTotal, runningCount;
+        bool usableAce;
+    };
+
+    /* What reset and step return */
+    struct StepResult {
+        Observation observation;
+
+        /* The reward of the finished game, 0 while it is unfinished */
+        float reward;
+
+        bool done;
+
+        GameResult outcome;
+    };
+
     class EnvironmentHandler {
     public:
         EnvironmentHandler();
 
+        /* Deals the recorded cards of one hand of a stream instead of random ones, the stream must outlive the handler */
+        EnvironmentHandler(const CardStream &cardStream, long long hand);
+
+        /*  Starts a new game in place, dealing the opening hand from the calling thread's generator.
+            Nothing is reallocated, so one handler can be reused for any number of episodes. */
+        StepResult reset();
+
+        /* Points the calling thread's generator at the substream of the episode before dealing, as seedEpisode does */
+        StepResult reset(std::uint64_t seed, std::uint64_t episode = 0);
+
+        /* Starts a new game replaying one recorded hand of a stream, the stream must outlive the game */
+        StepResult reset(const CardStream &cardStream, long long hand);
+
+        /*  Starts a new game in a chosen decision state rather than a dealt one, for exploring starts.
+            The player's cards are drawn from the calling thread's generator to make up the total, a soft hand being an ace
+            and one other card and a hard hand two or three cards without an ace. The dealer gets an up card worth
+            faceupTotal, 11 being an ace, and a random hole card. Totals outside the decision states, 12 to 21 against
+            2 to 11, are clamped into them. */
+        StepResult resetToState(int playerTotal, int faceupTotal, bool usableAce);
+
+        /* Plays the agent's action and returns the resulting observation, stepping a finished game does nothing */
+        StepResult step(Action action);
+
+        /*  The mode is kept across resets. With DECISION_POINTS a player total below 12, which cannot bust and which
+            every agent hits on, is hit automatically, and once the player stands the dealer draws out their hand before
+            the step returns. An agent that made random draws on those rounds would play differently, none of ours does. */
+        void setSteppingMode(SteppingMode mode);
+
+        SteppingMode getSteppingMode() const;
+
+        /* The observation and reward of the current state */
+        StepResult observe() const;
+
         /* Selects a card that has not been seen yet */
         int selectOutOfRemainingCards();
 
         /* Generates the required number of cards for the current game state */
-        std::vector<game_assets::Card> getNextHand();
+        Deal getNextHand();
 
-        void updateTotals(std::vector<game_assets::Card> cardsDealt, int numberOfCards);
+        void updateTotals(const Deal &cardsDealt);
 
         GameResult checkGameResult();
 
@@ -110,12 +264,31 @@ namespace environment {
 
         GameState getCurrentState() const;
 
+        /* The current state without copying it, which stays valid until the next step or reset */
+        const GameState& getState() const;
+
     private:
         GameState currentState;
 
         int numberOfRemainingCards;
 
-        std::unordered_set<int> seenIDs;
+        /* Bit i is set once the card with ID i has been dealt */
+        std::uint64_t seenIDs;
+
+        /* The stream being replayed, or a nullptr when cards are dealt at random */
+        const CardStream *cardStream;
+
+        long long streamHand;
+
+        int streamPosition;
+
+        SteppingMode steppingMode;
+
+        /* Plays forced rounds until the agent has a decision to make or the game is over */
+        void advanceToDecision();
+
+        /* Selects a random unseen card of a value from 1, for an ace, to 10 */
+        int selectCardOfValue(int value);
 
     };
 
@@ -1,6 +1,9 @@
 #include "environment.hpp"
 #include <gtest/gtest.h>
 
+#include <cstdio>
+#include <algorithm>
+
 class EnvironmentHandlerTests : public testing::Test {
     protected:
         EnvironmentHandlerTests() {}
@@ -8,7 +11,7 @@ class EnvironmentHandlerTests : public testing::Test {
         game_assets::Deck deck;
 
         // Utility function that calculates the value of the recorded cards
-        int calculateTotalCardValue(std::vector<int> &seenCards) const{
+        int calculateTotalCardValue(const std::vector<int> &seenCards) const{
             int total = 0;
             for (int i = 0; i < game_assets::DECK_SIZE; ++i){
                 if (seenCards[i]){
@@ -31,11 +34,11 @@ TEST_F(EnvironmentHandlerTests, InitialTotalsAreConsistent){
 
     environment::GameState s0 = e0.getCurrentState();
 
-    // Compare the player total with respect to the cards they have
-    EXPECT_EQ(calculateTotalCardValue(s0.getPlayerCards()), s0.getPlayerTotal());
+    // Compare the player total with respect to the cards they have, a usable ace counts for 10 more
+    EXPECT_EQ(calculateTotalCardValue(s0.getPlayerCards()) + (s0.doesPlayerHaveUsableAce() ? 10 : 0), s0.getPlayerTotal());
 
     // Initially the dealer total should be equal to the face up total
-    EXPECT_EQ(calculateTotalCardValue(s0.getDealerCards()), s0.getDealerTotal());
+    EXPECT_EQ(calculateTotalCardValue(s0.getDealerCards()) + (s0.doesDealerHaveUsableAce() ? 10 : 0), s0.getDealerTotal());
 }
 
 TEST_F(EnvironmentHandlerTests, InitialCardStatusIsCorrect){
@@ -164,4 +167,227 @@ TEST_F(GameStateTests, UsableAceIsCorrectlyExcludedUpperLimit){
     // The player's total should be equal to 21
     EXPECT_EQ(21, gs0.getPlayerTotal());
     
-}
\ No newline at end of file
+}
+
+TEST(CardStreamTests, PackedCardsRoundTrip){
+    environment::CardStream stream;
+    std::array<int, environment::MAX_CARDS_PER_HAND> first, second;
+
+    for (int i = 0; i < environment::MAX_CARDS_PER_HAND; ++i){
+        first[i] = i * 3;
+        second[i] = game_assets::DECK_SIZE - 1 - i;
+    }
+
+    stream.appendHand(first);
+    stream.appendHand(second);
+
+    EXPECT_EQ(2, stream.getNumberOfHands());
+    for (int i = 0; i < environment::MAX_CARDS_PER_HAND; ++i){
+        EXPECT_EQ(first[i], stream.getCard(0, i));
+        EXPECT_EQ(second[i], stream.getCard(1, i));
+    }
+}
+
+TEST(CardStreamTests, RecordedHandsHoldDistinctCards){
+    environment::CardStream stream = environment::CardStream::record(50, 1);
+
+    for (long long hand = 0; hand < stream.getNumberOfHands(); ++hand){
+        std::set<int> cardIDs;
+        for (int i = 0; i < environment::MAX_CARDS_PER_HAND; ++i){
+            cardIDs.insert(stream.getCard(hand, i));
+        }
+        EXPECT_EQ(environment::MAX_CARDS_PER_HAND, (int)cardIDs.size());
+        EXPECT_GE(*cardIDs.begin(), 0);
+        EXPECT_LT(*cardIDs.rbegin(), game_assets::DECK_SIZE);
+    }
+}
+
+TEST(CardStreamTests, ReplayedHandsDealTheRecordedCards){
+    environment::CardStream stream = environment::CardStream::record(3, 2);
+
+    environment::EnvironmentHandler e0(stream, 1), e1(stream, 1);
+    environment::GameState s0 = e0.getCurrentState();
+
+    // The player is dealt the 1st and 3rd cards and the dealer the 2nd and 4th
+    EXPECT_EQ(1, s0.getPlayerCards()[stream.getCard(1, 0)]);
+    EXPECT_EQ(1, s0.getDealerCards()[stream.getCard(1, 1)]);
+    EXPECT_EQ(1, s0.getPlayerCards()[stream.getCard(1, 2)]);
+    EXPECT_EQ(1, s0.getDealerCards()[stream.getCard(1, 3)]);
+
+    // Two handlers replaying the same hand play out identically
+    while (e0.getCurrentState().getOutcome() == environment::GameResult::UNFINISHED){
+        e0.simulateNextRound(environment::Action::STAND);
+        e1.simulateNextRound(environment::Action::STAND);
+    }
+    EXPECT_EQ(e0.getCurrentState().getDealerTotal(), e1.getCurrentState().getDealerTotal());
+    EXPECT_EQ(e0.getCurrentState().getOutcome(), e1.getCurrentState().getOutcome());
+}
+
+TEST(CardStreamTests, StreamFileRoundTrips){
+    environment::CardStream stream = environment::CardStream::record(10, 3), loaded;
+
+    std::string path = testing::TempDir() + "environment_unittest_stream.bin";
+    ASSERT_TRUE(stream.saveToFile(path));
+    ASSERT_TRUE(loaded.loadFromFile(path));
+
+    EXPECT_EQ(stream.getNumberOfHands(), loaded.getNumberOfHands());
+    for (int i = 0; i < environment::MAX_CARDS_PER_HAND; ++i){
+        EXPECT_EQ(stream.getCard(9, i), loaded.getCard(9, i));
+    }
+
+    EXPECT_FALSE(loaded.loadFromFile(path + ".missing"));
+    std::remove(path.c_str());
+}
+
+TEST(RandomEngineTests, SubstreamsAreReproducibleAndIndependent){
+    environment::RandomEngine first(7, 3), repeated(7, 3), otherStream(7, 4), otherSeed(8, 3);
+
+    int matchesOtherStream = 0, matchesOtherSeed = 0;
+    for (int i = 0; i < 1000; ++i){
+        environment::RandomEngine::result_type value = first();
+
+        EXPECT_EQ(value, repeated());
+        matchesOtherStream += value == otherStream();
+        matchesOtherSeed += value == otherSeed();
+    }
+
+    EXPECT_EQ(0, matchesOtherStream);
+    EXPECT_EQ(0, matchesOtherSeed);
+}
+
+TEST(RandomEngineTests, DiscardJumpsAhead){
+    environment::RandomEngine stepped(11, 0), jumped(11, 0);
+
+    for (int i = 0; i < 12345; ++i){
+        stepped();
+    }
+    jumped.discard(12345);
+
+    EXPECT_EQ(stepped(), jumped());
+}
+
+TEST(RandomEngineTests, SeededEpisodesDealTheSameHand){
+    environment::seedEpisode(42, 1000);
+    environment::GameState s0 = environment::EnvironmentHandler().getCurrentState();
+
+    // Draw from the thread's generator in between, as another episode would
+    environment::EnvironmentHandler();
+
+    environment::seedEpisode(42, 1000);
+    environment::GameState s1 = environment::EnvironmentHandler().getCurrentState();
+
+    EXPECT_EQ(s0.getPlayerCards(), s1.getPlayerCards());
+    EXPECT_EQ(s0.getDealerCards(), s1.getDealerCards());
+}
+
+TEST_F(EnvironmentHandlerTests, ResetDealsTheSameHandAsANewHandler){
+    environment::seedEpisode(42, 7);
+    environment::GameState fresh = environment::EnvironmentHandler().getCurrentState();
+
+    // Play the reused handler to the end first, so reset has to clear a finished game
+    while (!e0.step(environment::Action::HIT).done){}
+
+    environment::StepResult result = e0.reset(42, 7);
+    const environment::GameState &reset = e0.getState();
+
+    EXPECT_EQ(fresh.getPlayerCards(), reset.getPlayerCards());
+    EXPECT_EQ(fresh.getDealerCards(), reset.getDealerCards());
+    EXPECT_EQ(4, reset.getNumberOfSeenCards());
+    EXPECT_EQ(fresh.getPlayerTotal(), result.observation.playerTotal);
+    EXPECT_EQ(fresh.getFaceupTotal(), result.observation.faceupTotal);
+    EXPECT_EQ(fresh.getRunningCount(), result.observation.runningCount);
+}
+
+TEST_F(EnvironmentHandlerTests, StepReportsTheRewardOnceDone){
+    for (int episode = 0; episode < 100; ++episode){
+        environment::StepResult result = e0.reset(3, (std::uint64_t)episode);
+
+        while (!result.done){
+            EXPECT_EQ(0.0f, result.reward);
+            result = e0.step(result.observation.playerTotal < 17 ? environment::Action::HIT : environment::Action::STAND);
+        }
+
+        EXPECT_EQ(e0.getState().getOutcome(), result.outcome);
+        EXPECT_EQ(environment::generateRewardValue(result.outcome), result.reward);
+
+        // Stepping a finished game leaves it as it is
+        EXPECT_EQ(result.outcome, e0.step(environment::Action::HIT).outcome);
+    }
+}
+
+TEST_F(EnvironmentHandlerTests, DecisionPointStepsOnlyStopAtDecisions){
+    e0.setSteppingMode(environment::SteppingMode::DECISION_POINTS);
+
+    for (int episode = 0; episode < 1000; ++episode){
+        environment::StepResult result = e0.reset(3, (std::uint64_t)episode);
+
+        while (!result.done){
+            // The player can still bust, and the dealer has not started drawing
+            EXPECT_GE(result.observation.playerTotal, 12);
+            EXPECT_FALSE(e0.getState().dealerCardsShown());
+
+            result = e0.step(result.observation.playerTotal < 17 ? environment::Action::HIT : environment::Action::STAND);
+        }
+    }
+
+    // The mode is kept across resets
+    EXPECT_EQ(environment::SteppingMode::DECISION_POINTS, e0.getSteppingMode());
+}
+
+TEST_F(EnvironmentHandlerTests, DecisionPointsPlayTheSameGamesInFewerSteps){
+    environment::EnvironmentHandler decisions;
+    decisions.setSteppingMode(environment::SteppingMode::DECISION_POINTS);
+
+    int roundSteps = 0, decisionSteps = 0;
+
+    for (int episode = 0; episode < 1000; ++episode){
+        environment::StepResult rounds = e0.reset(5, (std::uint64_t)episode);
+        while (!rounds.done){
+            rounds = e0.step(rounds.observation.playerTotal < 15 ? environment::Action::HIT : environment::Action::STAND);
+            ++roundSteps;
+        }
+
+        environment::StepResult decided = decisions.reset(5, (std::uint64_t)episode);
+        while (!decided.done){
+            decided = decisions.step(decided.observation.playerTotal < 15 ? environment::Action::HIT : environment::Action::STAND);
+            ++decisionSteps;
+        }
+
+        EXPECT_EQ(e0.getState().getPlayerCards(), decisions.getState().getPlayerCards());
+        EXPECT_EQ(e0.getState().getDealerCards(), decisions.getState().getDealerCards());
+        EXPECT_EQ(rounds.outcome, decided.outcome);
+    }
+
+    EXPECT_LT(decisionSteps, roundSteps);
+}
+
+TEST_F(EnvironmentHandlerTests, ResetToStateDealsTheChosenState){
+    environment::seedEpisode(11, 0);
+
+    for (int playerTotal = 12; playerTotal <= environment::MAX_PLAYER_TOTAL; ++playerTotal){
+        for (int faceupTotal = 2; faceupTotal <= environment::MAX_DEALER_SHOWING; ++faceupTotal){
+            for (int usableAce = 0; usableAce < 2; ++usableAce){
+                environment::StepResult result = e0.resetToState(playerTotal, faceupTotal, usableAce == 1);
+                const environment::GameState &state = e0.getState();
+
+                EXPECT_FALSE(result.done);
+                EXPECT_EQ(playerTotal, result.observation.playerTotal);
+                EXPECT_EQ(faceupTotal, result.observation.faceupTotal);
+                EXPECT_EQ(usableAce == 1, result.observation.usableAce);
+
+                // The cards really make up the total, and a hard hand holds no ace that could be counted as 11
+                std::vector<int> playerCards = state.getPlayerCards();
+                EXPECT_EQ(calculateTotalCardValue(playerCards) + (usableAce ? 10 : 0), playerTotal);
+                if (!usableAce){
+                    for (int suit = 0; suit < 4; ++suit){
+                        EXPECT_EQ(0, playerCards[suit * 13]);
+                    }
+                }
+
+                // The up card and the hole card
+                std::vector<int> dealerCards = state.getDealerCards();
+                EXPECT_EQ(2, std::count(dealerCards.begin(), dealerCards.end(), 1));
+            }
+        }
+    }
+}
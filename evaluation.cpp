@@ -0,0 +1,243 @@
+#include "evaluation.hpp"
+
+#include <cmath>
+#include <thread>
+#include <vector>
+
+void evaluation::RewardTally::add(environment::GameResult outcome){
+    addReward(environment::generateRewardValue(outcome));
+}
+
+void evaluation::RewardTally::addReward(double reward){
+    ++hands;
+    wins += reward > 0.0;
+    losses += reward < 0.0;
+    pushes += reward == 0.0;
+    rewardSum += reward;
+    squaredRewardSum += reward * reward;
+}
+
+void evaluation::RewardTally::merge(const RewardTally &other){
+    hands += other.hands;
+    wins += other.wins;
+    losses += other.losses;
+    pushes += other.pushes;
+    rewardSum += other.rewardSum;
+    squaredRewardSum += other.squaredRewardSum;
+}
+
+namespace {
+    /* Lets the agent play an already dealt hand until the game is over */
+    environment::GameResult playToEnd(agents::Agent &agent, environment::EnvironmentHandler &testEnvironment){
+        const environment::GameState &state = testEnvironment.getState();
+
+        agent.reset();
+
+        while (state.getOutcome() == environment::GameResult::UNFINISHED){
+            testEnvironment.step(agent.considerState(state));
+        }
+
+        return state.getOutcome();
+    }
+}
+
+environment::GameResult evaluation::playHand(agents::Agent &agent){
+    environment::EnvironmentHandler testEnvironment;
+    return playToEnd(agent, testEnvironment);
+}
+
+environment::GameResult evaluation::playHand(agents::Agent &agent, const environment::CardStream &cardStream, long long hand){
+    environment::EnvironmentHandler testEnvironment(cardStream, hand);
+    return playToEnd(agent, testEnvironment);
+}
+
+evaluation::EvaluationResult evaluation::evaluate(const AgentFactory &createAgent, const EvaluationConfig &config){
+    int numberOfThreads = config.numberOfThreads > 0
+        ? config.numberOfThreads
+        : std::max(1, (int)std::thread::hardware_concurrency());
+
+    // Each thread keeps its own agent across batches, only the tallies are merged
+    std::vector<std::unique_ptr<agents::Agent>> threadAgents;
+    for (int t = 0; t < numberOfThreads; ++t){
+        threadAgents.push_back(createAgent());
+    }
+
+    RewardTally total;
+    EvaluationResult result = summarise(total, config.targetWidth);
+
+    while (total.hands < config.maxHands && !result.converged){
+        long long firstHand = total.hands;
+        long long batchHands = std::min(std::max(1LL, config.handsPerBatch), config.maxHands - firstHand);
+
+        std::vector<RewardTally> threadTallies(numberOfThreads);
+        std::vector<std::thread> threads;
+
+        for (int t = 0; t < numberOfThreads; ++t){
+            // Split the batch into one contiguous range of hands per thread
+            long long threadFirstHand = firstHand + batchHands * t / numberOfThreads;
+            long long threadLastHand = firstHand + batchHands * (t + 1) / numberOfThreads;
+
+            threads.emplace_back([&, t, threadFirstHand, threadLastHand](){
+                environment::EnvironmentHandler testEnvironment;
+                testEnvironment.setSteppingMode(config.steppingMode);
+
+                for (long long hand = threadFirstHand; hand < threadLastHand; ++hand){
+                    testEnvironment.reset(config.seed, (std::uint64_t)hand);
+                    threadTallies[t].add(playToEnd(*threadAgents[t], testEnvironment));
+                }
+            });
+        }
+
+        for (std::thread &thread: threads){
+            thread.join();
+        }
+
+        for (const RewardTally &tally: threadTallies){
+            total.merge(tally);
+        }
+
+        result = summarise(total, config.targetWidth);
+    }
+
+    return result;
+}
+
+evaluation::EvaluationResult evaluation::evaluate(const policy::FrozenPolicy &frozenPolicy, const EvaluationConfig &config){
+    return evaluate([&frozenPolicy](){
+        return std::unique_ptr<agents::Agent>(new agents::PolicyAgent(frozenPolicy));
+    }, config);
+}
+
+evaluation::EvaluationResult evaluation::evaluatePassiveAgent(const EvaluationConfig &config){
+    return evaluate([](){
+        return std::unique_ptr<agents::Agent>(new agents::PassiveAgent());
+    }, config);
+}
+
+evaluation::ComparisonResult evaluation::compare(
+    const std::vector<AgentFactory> &createAgents,
+    const environment::CardStream &cardStream,
+    int numberOfThreads,
+    std::uint64_t seed,
+    environment::SteppingMode steppingMode
+){
+    numberOfThreads = numberOfThreads > 0 ? numberOfThreads : std::max(1, (int)std::thread::hardware_concurrency());
+
+    int numberOfAgents = (int)createAgents.size();
+    long long numberOfHands = cardStream.getNumberOfHands();
+
+    // Every thread tallies each agent's rewards and each agent's difference from the first agent
+    std::vector<std::vector<RewardTally>> agentTallies(numberOfThreads, std::vector<RewardTally>(numberOfAgents));
+    std::vector<std::vector<RewardTally>> differenceTallies(numberOfThreads, std::vector<RewardTally>(numberOfAgents));
+    std::vector<std::thread> threads;
+
+    for (int t = 0; t < numberOfThreads; ++t){
+        long long firstHand = numberOfHands * t / numberOfThreads, lastHand = numberOfHands * (t + 1) / numberOfThreads;
+
+        threads.emplace_back([&, t, firstHand, lastHand](){
+            std::vector<std::unique_ptr<agents::Agent>> threadAgents;
+            for (const AgentFactory &createAgent: createAgents){
+                threadAgents.push_back(createAgent());
+            }
+
+            environment::EnvironmentHandler testEnvironment;
+            testEnvironment.setSteppingMode(steppingMode);
+
+            for (long long hand = firstHand; hand < lastHand; ++hand){
+                float baselineReward = 0.0f;
+
+                for (int a = 0; a < numberOfAgents; ++a){
+                    environment::seedEpisode(seed, (std::uint64_t)hand);
+                    testEnvironment.reset(cardStream, hand);
+                    float reward = environment::generateRewardValue(playToEnd(*threadAgents[a], testEnvironment));
+                    baselineReward = a == 0 ? reward : baselineReward;
+
+                    agentTallies[t][a].addReward(reward);
+                    differenceTallies[t][a].addReward(reward - baselineReward);
+                }
+            }
+        });
+    }
+
+    for (std::thread &thread: threads){
+        thread.join();
+    }
+
+    ComparisonResult result;
+    for (int a = 0; a < numberOfAgents; ++a){
+        RewardTally agentTotal, differenceTotal;
+
+        for (int t = 0; t < numberOfThreads; ++t){
+            agentTotal.merge(agentTallies[t][a]);
+            differenceTotal.merge(differenceTallies[t][a]);
+        }
+
+        result.agentResults.push_back(summarise(agentTotal, 0.0));
+        result.differences.push_back(summarise(differenceTotal, 0.0));
+    }
+
+    return result;
+}
+
+evaluation::EvaluationResult evaluation::summarise(const RewardTally &tally, double targetWidth){
+    EvaluationResult result;
+    result.tally = tally;
+    result.expectedReturn = result.standardError = result.lowerBound = result.upperBound = 0.0;
+    result.converged = false;
+
+    if (tally.hands == 0){
+        return result;
+    }
+
+    double n = (double)tally.hands;
+    result.expectedReturn = tally.rewardSum / n;
+
+    // The unbiased sample variance, which needs at least two hands
+    if (tally.hands > 1){
+        double variance = std::max(0.0, (tally.squaredRewardSum - n * result.expectedReturn * result.expectedReturn) / (n - 1.0));
+        result.standardError = std::sqrt(variance / n);
+
+        result.converged = targetWidth > 0.0 && tally.hands >= MIN_HANDS_FOR_CONVERGENCE && 2.0 * Z_95 * result.standardError < targetWidth;
+    }
+
+    result.lowerBound = result.expectedReturn - Z_95 * result.standardError;
+    result.upperBound = result.expectedReturn + Z_95 * result.standardError;
+
+    return result;
+}
+
+std::ostream& operator<<(std::ostream& o, const evaluation::EvaluationResult &r){
+    o << "Hands played = " << r.tally.hands <<
+        " (wins " << r.tally.wins << ", losses " << r.tally.losses << ", draws " << r.tally.pushes << ")\n" <<
+        "Expected return = " << r.expectedReturn << "\n" <<
+        "Standard error = " << r.standardError << "\n" <<
+        "95% confidence interval = [" << r.lowerBound << ", " << r.upperBound << "]\n" <<
+        (r.converged ? "Stopped once the interval was narrow enough\n" : "Stopped after the maximum number of hands\n");
+    return o;
+}
+
+std::ostream& operator<<(std::ostream& o, const evaluation::ComparisonResult &r){
+    auto variance = [](const evaluation::EvaluationResult &result){
+        return result.standardError * result.standardError * (double)result.tally.hands;
+    };
+
+    for (std::size_t a = 0; a < r.agentResults.size(); ++a){
+        o << "Agent " << a << ": expected return = " << r.agentResults[a].expectedReturn <<
+            ", 95% confidence interval = [" << r.agentResults[a].lowerBound << ", " << r.agentResults[a].upperBound << "]\n";
+    }
+
+    for (std::size_t a = 1; a < r.differences.size(); ++a){
+        const evaluation::EvaluationResult &difference = r.differences[a];
+
+        // The variance the difference would have if the agents had been dealt independent hands
+        double independentVariance = variance(r.agentResults[0]) + variance(r.agentResults[a]);
+
+        o << "Agent " << a << " - Agent 0: mean difference = " << difference.expectedReturn <<
+            ", standard error = " << difference.standardError <<
+            ", 95% confidence interval = [" << difference.lowerBound << ", " << difference.upperBound << "]\n" <<
+            "    paired variance = " << variance(difference) <<
+            ", independent variance = " << independentVariance <<
+            " (" << (variance(difference) > 0.0 ? independentVariance / variance(difference) : 0.0) << "x fewer hands needed)\n";
+    }
+    return o;
+}
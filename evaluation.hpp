@@ -0,0 +1,109 @@
+#pragma once
+
+#ifndef EVALUATION_H
+
+#define EVALUATION_H
+
+#include <memory>
+#include <vector>
+#include <functional>
+#include "agents.hpp"
+#include "policy.hpp"
+
+namespace evaluation {
+
+    /* The z value of a two sided 95% confidence interval */
+    const double Z_95 = 1.959963984540054;
+
+    /* A handful of identical hands would give an interval of width 0, so none is trusted before this many hands */
+    const long long MIN_HANDS_FOR_CONVERGENCE = 1000;
+
+    /* Creates a fresh agent for each evaluation thread, since agents hold their chosen action */
+    using AgentFactory = std::function<std::unique_ptr<agents::Agent>()>;
+
+    struct EvaluationConfig {
+        /* The most hands that will be played, even if the interval never gets narrow enough */
+        long long maxHands = 10000000;
+
+        /* Stop once the full width of the 95% interval is below this, 0 plays every hand */
+        double targetWidth = 0.0;
+
+        /* 0 uses every hardware thread */
+        int numberOfThreads = 0;
+
+        /*  Hands played, over all threads, between two checks of the interval.
+            This does not depend on the number of threads, so neither does the point at which a run stops. */
+        long long handsPerBatch = 100000;
+
+        /* Hand h is played on substream h of this seed, so a run gives the same result on any number of threads */
+        std::uint64_t seed = 0;
+
+        /* No agent makes a random draw on a forced round, so skipping them changes no result */
+        environment::SteppingMode steppingMode = environment::SteppingMode::DECISION_POINTS;
+    };
+
+    /* The running sums of the rewards of a set of hands, which can be merged across threads */
+    struct RewardTally {
+        long long hands = 0, wins = 0, losses = 0, pushes = 0;
+        double rewardSum = 0.0, squaredRewardSum = 0.0;
+
+        void add(environment::GameResult outcome);
+
+        /* Adds a reward directly, e.g. the difference between two agents' rewards on the same hand */
+        void addReward(double reward);
+
+        void merge(const RewardTally &other);
+    };
+
+    struct EvaluationResult {
+        RewardTally tally;
+
+        double expectedReturn, standardError, lowerBound, upperBound;
+
+        /* Whether the target width was reached before running out of hands */
+        bool converged;
+    };
+
+    /* The results of several agents played on the same recorded hands */
+    struct ComparisonResult {
+        std::vector<EvaluationResult> agentResults;
+
+        /*  The paired difference of each agent's reward minus the first agent's reward on every hand.
+            The first entry compares the first agent with itself and is always 0. */
+        std::vector<EvaluationResult> differences;
+    };
+
+    /* Plays a single hand to the end with the given agent, returning the outcome */
+    environment::GameResult playHand(agents::Agent &agent);
+
+    /* Plays one recorded hand of a stream to the end with the given agent */
+    environment::GameResult playHand(agents::Agent &agent, const environment::CardStream &cardStream, long long hand);
+
+    /* Plays hands in parallel across the configured threads until the interval is narrow enough or maxHands is reached */
+    EvaluationResult evaluate(const AgentFactory &createAgent, const EvaluationConfig &config);
+
+    /* Evaluates a frozen policy, which must outlive the call */
+    EvaluationResult evaluate(const policy::FrozenPolicy &frozenPolicy, const EvaluationConfig &config);
+
+    /* Evaluates the fixed rule of the PassiveAgent */
+    EvaluationResult evaluatePassiveAgent(const EvaluationConfig &config);
+
+    /*  Plays every agent on every hand of the stream, with the hands split into one contiguous shard per thread.
+        Since every agent sees the same cards the differences have far less variance than independent runs.
+        Each agent plays hand h on substream h of the seed, so random agents also share their random draws. */
+    ComparisonResult compare(
+        const std::vector<AgentFactory> &createAgents,
+        const environment::CardStream &cardStream,
+        int numberOfThreads = 0,
+        std::uint64_t seed = 0,
+        environment::SteppingMode steppingMode = environment::SteppingMode::DECISION_POINTS
+    );
+
+    /* Works out the mean, standard error and 95% interval from a tally */
+    EvaluationResult summarise(const RewardTally &tally, double targetWidth);
+}
+
+std::ostream& operator<<(std::ostream& o, const evaluation::EvaluationResult &r);
+std::ostream& operator<<(std::ostream& o, const evaluation::ComparisonResult &r);
+
+#endif /* EVALUATION_H */
@@ -0,0 +1,175 @@
+#include <gtest/gtest.h>
+
+#include <cmath>
+
+#include "evaluation.hpp"
+
+TEST(EvaluationTests, TallyCountsOutcomes){
+    evaluation::RewardTally tally;
+
+    tally.add(environment::GameResult::PLAYER_WIN);
+    tally.add(environment::GameResult::DEALER_WIN);
+    tally.add(environment::GameResult::DEALER_WIN);
+    tally.add(environment::GameResult::PUSH);
+
+    EXPECT_EQ(4, tally.hands);
+    EXPECT_EQ(1, tally.wins);
+    EXPECT_EQ(2, tally.losses);
+    EXPECT_EQ(1, tally.pushes);
+    EXPECT_DOUBLE_EQ(-1.0, tally.rewardSum);
+    EXPECT_DOUBLE_EQ(3.0, tally.squaredRewardSum);
+}
+
+TEST(EvaluationTests, MergedTalliesMatchOneTally){
+    evaluation::RewardTally first, second, combined;
+
+    for (int i = 0; i < 10; ++i){
+        environment::GameResult outcome = environment::GameResult(i % 3 == 0 ? 2 : -2);
+        (i < 4 ? first : second).add(outcome);
+        combined.add(outcome);
+    }
+
+    first.merge(second);
+
+    EXPECT_EQ(combined.hands, first.hands);
+    EXPECT_EQ(combined.wins, first.wins);
+    EXPECT_DOUBLE_EQ(combined.rewardSum, first.rewardSum);
+    EXPECT_DOUBLE_EQ(combined.squaredRewardSum, first.squaredRewardSum);
+}
+
+TEST(EvaluationTests, SummaryGivesIntervalAroundMean){
+    evaluation::RewardTally tally;
+
+    // An even split of wins and losses has mean 0 and variance n / (n - 1)
+    for (int i = 0; i < 2000; ++i){
+        tally.add(i % 2 ? environment::GameResult::PLAYER_WIN : environment::GameResult::DEALER_WIN);
+    }
+
+    evaluation::EvaluationResult result = evaluation::summarise(tally, 0.1);
+
+    EXPECT_DOUBLE_EQ(0.0, result.expectedReturn);
+    EXPECT_NEAR(std::sqrt(2000.0 / 1999.0 / 2000.0), result.standardError, 1e-12);
+    EXPECT_NEAR(-evaluation::Z_95 * result.standardError, result.lowerBound, 1e-12);
+    EXPECT_NEAR(evaluation::Z_95 * result.standardError, result.upperBound, 1e-12);
+
+    // The full width is about 0.088, narrower than 0.1 but not 0.05
+    EXPECT_TRUE(result.converged);
+    EXPECT_FALSE(evaluation::summarise(tally, 0.05).converged);
+}
+
+TEST(EvaluationTests, PlaysEveryHandAcrossThreads){
+    evaluation::EvaluationConfig config;
+    config.maxHands = 1001;
+    config.numberOfThreads = 3;
+    config.handsPerBatch = 100;
+
+    evaluation::EvaluationResult result = evaluation::evaluate(policy::FrozenPolicy(), config);
+
+    EXPECT_EQ(1001, result.tally.hands);
+    EXPECT_EQ(result.tally.hands, result.tally.wins + result.tally.losses + result.tally.pushes);
+    EXPECT_FALSE(result.converged);
+    EXPECT_LE(result.lowerBound, result.expectedReturn);
+    EXPECT_GE(result.upperBound, result.expectedReturn);
+}
+
+TEST(EvaluationTests, StopsOnceIntervalIsNarrowEnough){
+    evaluation::EvaluationConfig config;
+    config.maxHands = 1000000;
+    config.targetWidth = 0.2;
+    config.numberOfThreads = 2;
+    config.handsPerBatch = 1000;
+
+    evaluation::EvaluationResult result = evaluation::evaluatePassiveAgent(config);
+
+    // Rewards lie in [-1, 1], so a width of 0.2 needs at most a few hundred hands after the minimum
+    EXPECT_TRUE(result.converged);
+    EXPECT_LT(result.tally.hands, config.maxHands);
+    EXPECT_LT(result.upperBound - result.lowerBound, 0.2);
+}
+
+TEST(EvaluationTests, IdenticalPoliciesHaveNoPairedDifference){
+    environment::CardStream stream = environment::CardStream::record(2000, 4);
+    policy::FrozenPolicy frozenPolicy;
+
+    evaluation::AgentFactory createAgent = [&frozenPolicy](){
+        return std::unique_ptr<agents::Agent>(new agents::PolicyAgent(frozenPolicy));
+    };
+
+    evaluation::ComparisonResult result = evaluation::compare({createAgent, createAgent}, stream, 3);
+
+    ASSERT_EQ(2u, result.differences.size());
+    EXPECT_EQ(2000, result.agentResults[1].tally.hands);
+    EXPECT_DOUBLE_EQ(result.agentResults[0].expectedReturn, result.agentResults[1].expectedReturn);
+
+    // Deterministic agents on the same cards get the same reward on every hand
+    EXPECT_EQ(2000, result.differences[1].tally.pushes);
+    EXPECT_DOUBLE_EQ(0.0, result.differences[1].standardError);
+}
+
+TEST(EvaluationTests, PairedDifferenceMatchesSeparateRuns){
+    environment::CardStream stream = environment::CardStream::record(2000, 4);
+    policy::FrozenPolicy standAll, hitSixteen;
+
+    function::StateActionFunction Q;
+    for (int j = 0; j <= environment::MAX_DEALER_SHOWING; ++j){
+        *Q.getImage(16, j, 1, 0) = 1.0f;
+    }
+    hitSixteen = policy::FrozenPolicy::fromFunction(Q);
+
+    std::vector<evaluation::AgentFactory> createAgents = {
+        [&standAll](){ return std::unique_ptr<agents::Agent>(new agents::PolicyAgent(standAll)); },
+        [&hitSixteen](){ return std::unique_ptr<agents::Agent>(new agents::PolicyAgent(hitSixteen)); }
+    };
+
+    evaluation::ComparisonResult result = evaluation::compare(createAgents, stream, 2);
+
+    // The mean difference is exactly the difference of the means, however the hands were sharded
+    EXPECT_NEAR(
+        result.agentResults[1].expectedReturn - result.agentResults[0].expectedReturn,
+        result.differences[1].expectedReturn,
+        1e-12
+    );
+
+    // Only the hard 16 hands differ, so pairing removes most of the variance
+    EXPECT_LT(result.differences[1].standardError, result.agentResults[0].standardError);
+}
+
+TEST(EvaluationTests, SeededRunsDoNotDependOnThreadCount){
+    evaluation::EvaluationConfig config;
+    config.maxHands = 3000;
+    config.handsPerBatch = 1000;
+    config.targetWidth = 0.08;
+    config.seed = 2024;
+
+    config.numberOfThreads = 1;
+    evaluation::EvaluationResult single = evaluation::evaluatePassiveAgent(config);
+
+    config.numberOfThreads = 4;
+    evaluation::EvaluationResult parallel = evaluation::evaluatePassiveAgent(config);
+
+    // The passive agent draws random numbers too, which also come from each hand's substream
+    EXPECT_EQ(single.tally.hands, parallel.tally.hands);
+    EXPECT_EQ(single.tally.wins, parallel.tally.wins);
+    EXPECT_EQ(single.tally.losses, parallel.tally.losses);
+    EXPECT_EQ(single.expectedReturn, parallel.expectedReturn);
+    EXPECT_EQ(single.standardError, parallel.standardError);
+    EXPECT_EQ(single.converged, parallel.converged);
+}
+
+TEST(EvaluationTests, SkippingForcedRoundsChangesNoResult){
+    evaluation::EvaluationConfig config;
+    config.maxHands = 3000;
+    config.numberOfThreads = 2;
+    config.seed = 2024;
+
+    config.steppingMode = environment::SteppingMode::EVERY_ROUND;
+    evaluation::EvaluationResult rounds = evaluation::evaluatePassiveAgent(config);
+
+    config.steppingMode = environment::SteppingMode::DECISION_POINTS;
+    evaluation::EvaluationResult decisions = evaluation::evaluatePassiveAgent(config);
+
+    // The passive agent only draws a random number when it has a decision to make
+    EXPECT_EQ(rounds.tally.wins, decisions.tally.wins);
+    EXPECT_EQ(rounds.tally.losses, decisions.tally.losses);
+    EXPECT_EQ(rounds.expectedReturn, decisions.expectedReturn);
+}
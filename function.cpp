@@ -1,5 +1,19 @@
 #include "function.hpp"
 
+#include <fstream>
+
+namespace {
+    /* Identifies a checkpoint file along with the dimensions of the matrix it was written from */
+    const char CHECKPOINT_MAGIC[4] = {'B', 'J', 'Q', 'F'};
+}
+
+// The nested arrays must have no padding for the images to be viewed as a single block
+static_assert(
+    sizeof(function::StateActionMatrix<std::array<float, 2>>) == sizeof(float) *
+        function::FUNCTION_SHAPE[0] * function::FUNCTION_SHAPE[1] * function::FUNCTION_SHAPE[2] * function::FUNCTION_SHAPE[3],
+    "StateActionMatrix is not contiguous"
+);
+
 /* Calls helper funciton to initialises all images */
 function::StateActionFunction::StateActionFunction(){
     this->initialiseImages();
@@ -38,6 +52,11 @@ float* function::StateActionFunction::getImage(int i, int j, int k, int l){
 
     return &this->mapping[i][j][k][l];
 }
+const float* function::StateActionFunction::getImage(int i, int j, int k, int l) const{
+    // The bounds checks are the same, only the image cannot be written through
+    return const_cast<StateActionFunction*>(this)->getImage(i, j, k, l);
+}
+
 // The initial significantly harder to read code for the above function
 // return *( (*( (*(this->mapping.begin() + i)).begin() + j)).begin() + k);
 
@@ -53,8 +72,51 @@ void function::StateActionFunction::initialiseImages(){
     }
 }
 
+float* function::StateActionFunction::data(){
+    return &this->mapping[0][0][0][0];
+}
+
+const float* function::StateActionFunction::data() const{
+    return &this->mapping[0][0][0][0];
+}
+
+bool function::StateActionFunction::saveToFile(const std::string &path) const{
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+
+    file.write(CHECKPOINT_MAGIC, sizeof(CHECKPOINT_MAGIC));
+    file.write(reinterpret_cast<const char*>(function::FUNCTION_SHAPE), sizeof(function::FUNCTION_SHAPE));
+    file.write(reinterpret_cast<const char*>(&this->mapping), sizeof(this->mapping));
+
+    return (bool)file;
+}
+
+bool function::StateActionFunction::loadFromFile(const std::string &path){
+    std::ifstream file(path, std::ios::binary);
+
+    char magic[sizeof(CHECKPOINT_MAGIC)];
+    int dimensions[function::NUMBER_OF_DIMENSIONS];
+    file.read(magic, sizeof(magic));
+    file.read(reinterpret_cast<char*>(dimensions), sizeof(dimensions));
+
+    if (!file || !std::equal(magic, magic + sizeof(magic), CHECKPOINT_MAGIC) ||
+        !std::equal(dimensions, dimensions + function::NUMBER_OF_DIMENSIONS, function::FUNCTION_SHAPE)){
+        return false;
+    }
+
+    // Read into a copy so a truncated file does not leave the function half overwritten
+    StateActionMatrix<std::array<float, 2>> loaded;
+    file.read(reinterpret_cast<char*>(&loaded), sizeof(loaded));
+
+    if (!file){
+        return false;
+    }
+
+    this->mapping = loaded;
+    return true;
+}
+
 /* Outputs the state */
-std::ostream& operator<<(std::ostream& o, function::StateActionFunction &func){
+std::ostream& operator<<(std::ostream& o, const function::StateActionFunction &func){
     std::cout << "The state (S) consists of the player sum (p) and the shown dealer sum (d).\n"<<
                  "The reward (G) is given for when the agent hits (h) and stands (s).\n\n";
 
@@ -6,6 +6,7 @@
 
 #include <utility>
 #include <array>
+#include <string>
 #include "environment.hpp"
 
 /* PLAYERCARDS AND DEALER CARDS IN GAMESTATE CAN BE IMPLEMENTED AS A VECTOR OF INTEGERS 
@@ -16,6 +17,12 @@
 
 namespace function {
 
+    /* The extent of each index of a StateActionFunction: player total, dealer face up total, action and usable ace */
+    const int NUMBER_OF_DIMENSIONS = 4;
+    constexpr int FUNCTION_SHAPE[NUMBER_OF_DIMENSIONS] = {
+        environment::MAX_PLAYER_TOTAL + 1, environment::MAX_DEALER_SHOWING + 1, environment::MAX_POSSIBLE_ACTIONS, 2
+    };
+
     /*  3D array that maps a state (represented by the player sum and dealer sum)
         and an action (represented by hit or stand) to a float.
         It would be smarter to convert this into a template for mapping to arbitrary types.*/
@@ -39,7 +46,21 @@ namespace function {
             /* Returns the image of a given function input */
             float* getImage(int i, int j, int k, int l);
 
+            const float* getImage(int i, int j, int k, int l) const;
+
             void initialiseImages();
+
+            /*  The images as one contiguous row-major block laid out as FUNCTION_SHAPE,
+                so they can be viewed in place, e.g. as a NumPy array */
+            float* data();
+
+            const float* data() const;
+
+            /* Writes every image to a binary checkpoint so a trained function can be reloaded later */
+            bool saveToFile(const std::string &path) const;
+
+            /* Returns false, leaving the images untouched, if the file is missing or has different dimensions */
+            bool loadFromFile(const std::string &path);
         private:
             /*  A 3D array that stores actions taken in each state for the function
                 Stores rows for the player sum from i = 0 to i = 21,
@@ -54,6 +75,6 @@ namespace function {
     /* Implement a state function super class that allows a state to be mapped to an arbitrary type */
 }
 
-std::ostream& operator<<(std::ostream& o, function::StateActionFunction &f);
+std::ostream& operator<<(std::ostream& o, const function::StateActionFunction &f);
 
 #endif /* FUNCTION_H */
\ No newline at end of file
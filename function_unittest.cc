@@ -1,5 +1,7 @@
 #include <gtest/gtest.h>
 
+#include <cstdio>
+#include <string>
 #include <numeric>
 
 #include "function.hpp"
@@ -28,4 +30,25 @@ TEST_F(FunctionTests, StoresCorrectValueWithUsableAce){
     // Expects the state and action to return the same pointer as the translated image
     EXPECT_EQ(func0.getImage(18, 6, 1, 1), func0(state, environment::Action::HIT));
 
-}
\ No newline at end of file
+}
+
+TEST_F(FunctionTests, CheckpointRoundTrips){
+    *func0.getImage(16, 10, 1, 0) = -0.25f;
+    *func0.getImage(20, 6, 0, 1) = 0.75f;
+
+    std::string path = testing::TempDir() + "function_unittest_checkpoint.bin";
+    ASSERT_TRUE(func0.saveToFile(path));
+
+    function::StateActionFunction loaded;
+    ASSERT_TRUE(loaded.loadFromFile(path));
+
+    EXPECT_EQ(-0.25f, *loaded.getImage(16, 10, 1, 0));
+    EXPECT_EQ(0.75f, *loaded.getImage(20, 6, 0, 1));
+    EXPECT_EQ(0.0f, *loaded.getImage(12, 2, 0, 0));
+
+    // A missing file leaves the function as it was
+    EXPECT_FALSE(loaded.loadFromFile(path + ".missing"));
+    EXPECT_EQ(0.75f, *loaded.getImage(20, 6, 0, 1));
+
+    std::remove(path.c_str());
+}
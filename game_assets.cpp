@@ -1,7 +1,5 @@
 #include "game_assets.hpp"
 
-using std::cout;
-
 /* Stores all possible cards of the game */
 game_assets::Deck::Deck(){
     int intCardValue, suiteID;
@@ -40,16 +38,16 @@ game_assets::Suite game_assets::Card::getSuite() const{
 }
 
 std::ostream& operator<<(std::ostream& o, game_assets::CardVal v) {
-    cout << static_cast<int>(v);
+    o << static_cast<int>(v);
     return o;
 }
 
 std::ostream& operator<<(std::ostream& o, game_assets::Suite s) {
-    cout << static_cast<char>(s);
+    o << static_cast<char>(s);
     return o;
 }
 
 std::ostream& operator<<(std::ostream& o, game_assets::Card c) {
-    cout << "{ Value = " << c.getValue() << ", Suite = " << c.getSuite() << "} ";
+    o << "{ Value = " << c.getValue() << ", Suite = " << c.getSuite() << "} ";
     return o;
 }
\ No newline at end of file
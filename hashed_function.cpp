@@ -0,0 +1,188 @@
+#include "hashed_function.hpp"
+
+#include <cmath>
+#include <algorithm>
+
+function::StateKey function::StateKey::fromState(const environment::GameState &state, bool useDeckFeatures){
+    StateKey key;
+    key.playerTotal = state.getPlayerTotal();
+    key.dealerShowing = state.getFaceupTotal();
+    key.usableAce = state.doesPlayerHaveUsableAce();
+    key.trueCount = 0;
+    key.penetration = 0;
+
+    if (!useDeckFeatures){
+        return key;
+    }
+
+    int remainingCards = game_assets::DECK_SIZE - state.getNumberOfSeenCards();
+
+    // Scale the running count to what it would be for a full deck
+    float scaledCount = remainingCards > 0
+        ? (float)state.getRunningCount() * game_assets::DECK_SIZE / remainingCards
+        : (float)state.getRunningCount();
+
+    key.trueCount = std::max(-128, std::min(127, (int)std::lround(scaledCount)));
+    key.penetration = std::min(63, state.getNumberOfSeenCards());
+
+    return key;
+}
+
+std::uint32_t function::StateKey::pack(environment::Action action) const{
+    return  (std::uint32_t)playerTotal |
+            (std::uint32_t)dealerShowing << 5 |
+            (std::uint32_t)usableAce << 9 |
+            (std::uint32_t)(action == environment::Action::HIT) << 10 |
+            (std::uint32_t)(trueCount + 128) << 11 |
+            (std::uint32_t)penetration << 19;
+}
+
+function::HashedStateActionFunction::HashedStateActionFunction() : HashedStateActionFunction(true){}
+
+function::HashedStateActionFunction::HashedStateActionFunction(bool useDeckFeatures, int initialCapacity) :
+    useDeckFeatures(useDeckFeatures), numberOfEntries(0), maxProbeLength(0), capacityBits(1) {
+        // Round the capacity up to a power of 2 so the hash can be reduced with a shift
+        while ((1 << capacityBits) < initialCapacity){
+            ++capacityBits;
+        }
+        slots.assign((std::size_t)1 << capacityBits, Slot{EMPTY_KEY, 0});
+}
+
+/* Returns the memory location that a given state and action is mapped to internally */
+float* function::HashedStateActionFunction::operator()(environment::GameState state, environment::Action action){
+    return (*this)(StateKey::fromState(state, useDeckFeatures), action);
+}
+
+float* function::HashedStateActionFunction::operator()(const StateKey &key, environment::Action action){
+    // Mirror the bounds of the dense function so both can be used interchangeably
+    if ( key.playerTotal < 0 || key.dealerShowing < 0 ||
+         key.playerTotal > environment::MAX_PLAYER_TOTAL ||
+         key.dealerShowing > environment::MAX_DEALER_SHOWING )
+    {
+        return nullptr;
+    }
+
+    return lookup(key.pack(action));
+}
+
+float* function::HashedStateActionFunction::getImage(int i, int j, int k, int l){
+
+    // If any of the indices given are out of bounds, do not attempt to access pointers
+    if ( i < 0 || j < 0 || k < 0 ||
+         i > environment::MAX_PLAYER_TOTAL ||
+         j > environment::MAX_DEALER_SHOWING ||
+         k >= environment::MAX_POSSIBLE_ACTIONS ||
+         (l != 1 && l != 0) )
+    {
+            std::cout << "Image cannot be returned because indices are out of bound\n";
+            std::cout << "i = " << i << ", j = " << j << ", k = " << k << ", l = " << l << "\n";
+            return nullptr;
+    }
+
+    StateKey key{i, j, l == 1, 0, 0};
+
+    return lookup(key.pack(environment::Action(k == 1)));
+}
+
+/* Drops all stored keys and values so every image reads as 0 again */
+void function::HashedStateActionFunction::initialiseImages(){
+    std::fill(slots.begin(), slots.end(), Slot{EMPTY_KEY, 0});
+    arena.clear();
+    numberOfEntries = 0;
+    maxProbeLength = 0;
+}
+
+int function::HashedStateActionFunction::size() const{
+    return numberOfEntries;
+}
+
+int function::HashedStateActionFunction::capacity() const{
+    return (int)slots.size();
+}
+
+int function::HashedStateActionFunction::getMaxProbeLength() const{
+    return maxProbeLength;
+}
+
+std::size_t function::HashedStateActionFunction::memoryUsage() const{
+    return slots.size() * sizeof(Slot) + arena.size() * ARENA_BLOCK_SIZE * sizeof(float);
+}
+
+/* Finds the value of a packed key, inserting a zeroed value if it has not been seen before */
+float* function::HashedStateActionFunction::lookup(std::uint32_t packedKey){
+    std::size_t mask = slots.size() - 1;
+
+    for (std::size_t i = hashSlot(packedKey); ; i = (i + 1) & mask){
+        if (slots[i].key == packedKey){
+            return valueAt(slots[i].valueIndex);
+        }
+
+        if (slots[i].key == EMPTY_KEY){
+            break;
+        }
+    }
+
+    // The key is new, so make room for it first if the table is too full to keep probes short
+    if ((numberOfEntries + 1) * MAX_LOAD_DENOMINATOR > capacity() * MAX_LOAD_NUMERATOR){
+        grow();
+    }
+
+    Slot slot{packedKey, allocateValue()};
+    int probeLength = insertSlot(slot);
+
+    // An unlucky cluster is broken up by growing, rather than letting every later lookup pay for it
+    while (probeLength > MAX_PROBE_LENGTH){
+        grow();
+        probeLength = maxProbeLength;
+    }
+
+    ++numberOfEntries;
+
+    return valueAt(slot.valueIndex);
+}
+
+std::uint32_t function::HashedStateActionFunction::allocateValue(){
+    std::uint32_t valueIndex = (std::uint32_t)numberOfEntries;
+
+    if (valueIndex / ARENA_BLOCK_SIZE >= arena.size()){
+        arena.emplace_back(new float[ARENA_BLOCK_SIZE]());
+    }
+
+    return valueIndex;
+}
+
+float* function::HashedStateActionFunction::valueAt(std::uint32_t valueIndex) const{
+    return &arena[valueIndex / ARENA_BLOCK_SIZE][valueIndex % ARENA_BLOCK_SIZE];
+}
+
+void function::HashedStateActionFunction::grow(){
+    std::vector<Slot> previousSlots(((std::size_t)1 << (capacityBits + 1)), Slot{EMPTY_KEY, 0});
+    previousSlots.swap(slots);
+    ++capacityBits;
+    maxProbeLength = 0;
+
+    for (const Slot &slot: previousSlots){
+        if (slot.key != EMPTY_KEY){
+            insertSlot(slot);
+        }
+    }
+}
+
+int function::HashedStateActionFunction::insertSlot(Slot slot){
+    std::size_t mask = slots.size() - 1;
+    int probeLength = 1;
+
+    for (std::size_t i = hashSlot(slot.key); slots[i].key != EMPTY_KEY; i = (i + 1) & mask){
+        ++probeLength;
+    }
+
+    slots[(hashSlot(slot.key) + probeLength - 1) & mask] = slot;
+    maxProbeLength = std::max(maxProbeLength, probeLength);
+
+    return probeLength;
+}
+
+/* Fibonacci hashing spreads the densely packed keys across the whole table */
+std::size_t function::HashedStateActionFunction::hashSlot(std::uint32_t packedKey) const{
+    return (std::size_t)((packedKey * 0x9E3779B1u) >> (32 - capacityBits));
+}
@@ -0,0 +1,117 @@
+#pragma once
+
+#ifndef HASHED_FUNCTION_H
+
+#define HASHED_FUNCTION_H
+
+#include <memory>
+#include <vector>
+#include <cstdint>
+#include "environment.hpp"
+
+namespace function {
+
+    /* The hashed function never fills more than half of its slots, which keeps linear probe sequences short */
+    const int MAX_LOAD_NUMERATOR = 1, MAX_LOAD_DENOMINATOR = 2;
+
+    /* A probe sequence longer than this triggers growth even below the maximum load */
+    const int MAX_PROBE_LENGTH = 16;
+
+    /* The number of floats held by each arena block */
+    const int ARENA_BLOCK_SIZE = 1024;
+
+    /*  The features of a state once the deck composition is taken into account.
+        The dense StateActionMatrix can only be indexed by the player total, the face up dealer total
+        and the usable ace flag, so the count and penetration are only usable through the hashed function. */
+    struct StateKey {
+        int playerTotal;
+        int dealerShowing;
+        bool usableAce;
+        /* Hi-Lo running count scaled to a full deck and rounded, clamped to [-128, 127] */
+        int trueCount;
+        /* The number of cards dealt out of the deck so far, at most 63 */
+        int penetration;
+
+        /* Extracts the key from a state, leaving the count and penetration as 0 if the deck features are unused */
+        static StateKey fromState(const environment::GameState &state, bool useDeckFeatures);
+
+        /*  Packs the key and the action into 25 bits:
+            bits 0-4 player total, bits 5-8 dealer showing, bit 9 usable ace, bit 10 action,
+            bits 11-18 the true count offset by 128 and bits 19-24 the penetration. */
+        std::uint32_t pack(environment::Action action) const;
+    };
+
+    /*  Maps a state and action pair to a float through an open-addressing hash table.
+        Only the state-action pairs that have been looked up are stored, so memory grows
+        with the number of visited states rather than with the size of the feature space.
+
+        Each slot holds the packed key and the index of its value in an arena of fixed size blocks,
+        so a pointer returned by operator() stays valid when the slots are rehashed. */
+    class HashedStateActionFunction {
+        public:
+            HashedStateActionFunction();
+
+            /* Takes whether the count and penetration are part of the key, and the initial number of slots (rounded up to a power of 2) */
+            HashedStateActionFunction(bool useDeckFeatures, int initialCapacity = 256);
+
+            /* Returns the memory location a state and action is mapped to, inserting a 0 if it is unseen */
+            float* operator()(environment::GameState state, environment::Action action);
+
+            float* operator()(const StateKey &key, environment::Action action);
+
+            /*  Returns the image of a given function input using the same indices as StateActionFunction,
+                the count and penetration are taken to be 0 */
+            float* getImage(int i, int j, int k, int l);
+
+            /* Removes every stored image, releasing the arena */
+            void initialiseImages();
+
+            /* The number of state-action pairs stored */
+            int size() const;
+
+            int capacity() const;
+
+            /* The longest probe sequence currently needed to find any stored key */
+            int getMaxProbeLength() const;
+
+            /* Bytes held by the slots and the arena blocks */
+            std::size_t memoryUsage() const;
+
+        private:
+            /* Marks a slot as free, no packed key reaches it since only 25 bits are used */
+            static const std::uint32_t EMPTY_KEY = 0xFFFFFFFFu;
+
+            struct Slot {
+                std::uint32_t key;
+                std::uint32_t valueIndex;
+            };
+
+            bool useDeckFeatures;
+
+            int numberOfEntries, maxProbeLength;
+
+            /* log2 of the number of slots */
+            int capacityBits;
+
+            std::vector<Slot> slots;
+
+            std::vector<std::unique_ptr<float[]>> arena;
+
+            float* lookup(std::uint32_t packedKey);
+
+            /* Hands out the next arena cell, allocating a new block when the last one is full */
+            std::uint32_t allocateValue();
+
+            float* valueAt(std::uint32_t valueIndex) const;
+
+            /* Doubles the number of slots and reinserts every key */
+            void grow();
+
+            /* Places a key in the slot table, returning the length of the probe sequence used */
+            int insertSlot(Slot slot);
+
+            std::size_t hashSlot(std::uint32_t packedKey) const;
+    };
+}
+
+#endif /* HASHED_FUNCTION_H */
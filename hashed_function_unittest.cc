@@ -0,0 +1,97 @@
+#include <gtest/gtest.h>
+
+#include "function.hpp"
+#include "hashed_function.hpp"
+
+class HashedFunctionTests : public testing::Test {
+    protected:
+        HashedFunctionTests() : func0(false), countingFunc(true, 4) {}
+
+        function::HashedStateActionFunction func0, countingFunc;
+        game_assets::Deck deck;
+};
+
+TEST_F(HashedFunctionTests, StoresCorrectValueWithUsableAce){
+    environment::GameState state;
+
+    // Gives the dealer the Six of Hearts
+    state.addCard( deck[5], false );
+
+    // Gives the player the Ace of Diamonds
+    state.addCard( deck[13], true );
+
+    // Gives the player the Seven of Diamonds
+    state.addCard( deck[19], true );
+
+    // Without the deck features the state resolves to the same image as the dense function
+    EXPECT_EQ(func0.getImage(18, 6, 1, 1), func0(state, environment::Action::HIT));
+
+    // Unseen images start at 0, like the dense function
+    EXPECT_EQ(0.0f, *func0(state, environment::Action::STAND));
+}
+
+TEST_F(HashedFunctionTests, OutOfBoundsStatesAreRejected){
+    EXPECT_EQ(nullptr, func0.getImage(environment::MAX_PLAYER_TOTAL + 1, 2, 0, 0));
+    EXPECT_EQ(nullptr, func0.getImage(12, 2, 2, 0));
+
+    function::StateKey bustKey{25, 10, false, 0, 0};
+    EXPECT_EQ(nullptr, func0(bustKey, environment::Action::HIT));
+}
+
+TEST_F(HashedFunctionTests, CountSeparatesOtherwiseEqualStates){
+    environment::GameState lowCards, highCards;
+
+    // Player 2 + 4 + 10 = 16 against a dealer 5
+    lowCards.addCard( deck[4], false );
+    lowCards.addCard( deck[1], true );
+    lowCards.addCard( deck[3], true );
+    lowCards.addCard( deck[9], true );
+
+    // Player King + 6 = 16 against a dealer 5
+    highCards.addCard( deck[17], false );
+    highCards.addCard( deck[12], true );
+    highCards.addCard( deck[5], true );
+
+    EXPECT_EQ(2, lowCards.getRunningCount());
+    EXPECT_EQ(1, highCards.getRunningCount());
+    EXPECT_EQ(lowCards.getPlayerTotal(), highCards.getPlayerTotal());
+
+    EXPECT_NE(countingFunc(lowCards, environment::Action::HIT), countingFunc(highCards, environment::Action::HIT));
+
+    // The dense view ignores the count, so both states share one image
+    EXPECT_EQ(func0(lowCards, environment::Action::HIT), func0(highCards, environment::Action::HIT));
+}
+
+TEST_F(HashedFunctionTests, PointersSurviveGrowth){
+    float *first = countingFunc.getImage(12, 2, 0, 0);
+    *first = 0.5f;
+
+    // Visit every dense cell so the table has to grow several times
+    for (int i = 0; i <= environment::MAX_PLAYER_TOTAL; ++i){
+        for (int j = 0; j <= environment::MAX_DEALER_SHOWING; ++j){
+            for (int k = 0; k < environment::MAX_POSSIBLE_ACTIONS; ++k){
+                for (int l = 0; l < 2; ++l){
+                    *countingFunc.getImage(i, j, k, l) += 1.0f;
+                }
+            }
+        }
+    }
+
+    int denseCells = (environment::MAX_PLAYER_TOTAL + 1) * (environment::MAX_DEALER_SHOWING + 1) * environment::MAX_POSSIBLE_ACTIONS * 2;
+
+    EXPECT_EQ(denseCells, countingFunc.size());
+    EXPECT_EQ(first, countingFunc.getImage(12, 2, 0, 0));
+    EXPECT_EQ(1.5f, *first);
+
+    // The table never runs more than half full and keeps its probes bounded
+    EXPECT_LE(2 * countingFunc.size(), countingFunc.capacity());
+    EXPECT_LE(countingFunc.getMaxProbeLength(), function::MAX_PROBE_LENGTH);
+}
+
+TEST_F(HashedFunctionTests, InitialisingClearsImages){
+    *func0.getImage(20, 10, 0, 0) = 1.0f;
+    func0.initialiseImages();
+
+    EXPECT_EQ(0, func0.size());
+    EXPECT_EQ(0.0f, *func0.getImage(20, 10, 0, 0));
+}
@@ -0,0 +1,120 @@
+#include "interleaving.hpp"
+
+#include <algorithm>
+#include <utility>
+
+namespace {
+    /* A hint only, so compilers without the builtin simply load the line when it is first read */
+    inline void prefetchLine(const void *address){
+#if defined(__GNUC__) || defined(__clang__)
+        __builtin_prefetch(address, 1, 3);
+#else
+        (void)address;
+#endif
+    }
+}
+
+interleaving::InterleavedTrainer::InterleavedTrainer(
+    function::StateActionFunction &Q,
+    training::AdaptiveStepSize &stepSizes,
+    agents::GreedyAgent &agent,
+    std::uint64_t seed,
+    int episodesInFlight,
+    environment::SteppingMode steppingMode
+) : Q(Q), stepSizes(stepSizes), agent(agent), seed(seed), slots(std::max(1, episodesInFlight)) {
+    for (SuspendedEpisode &suspended: slots){
+        suspended.testEnvironment.setSteppingMode(steppingMode);
+        suspended.visitedStatesAndActions.reserve(training::MAX_RECORDED_STATES);
+    }
+}
+
+double interleaving::InterleavedTrainer::train(long long firstEpisode, long long lastEpisode, const EpisodeCallback &onEpisodeEnd){
+    double rewardSum = 0.0;
+    long long nextEpisode = firstEpisode;
+    int inFlight = 0;
+
+    for (SuspendedEpisode &suspended: slots){
+        if (nextEpisode < lastEpisode){
+            start(suspended, nextEpisode++);
+            ++inFlight;
+        }
+    }
+
+    while (inFlight > 0){
+        // Every line is requested before any is needed, so the loads of all the games overlap
+        for (const SuspendedEpisode &suspended: slots){
+            if (suspended.inFlight){
+                prefetch(suspended);
+            }
+        }
+
+        for (SuspendedEpisode &suspended: slots){
+            if (!suspended.inFlight || !resume(suspended)){
+                continue;
+            }
+
+            float reward = suspended.testEnvironment.observe().reward;
+            training::updateQValues(Q, suspended.visitedStatesAndActions, reward, stepSizes);
+            rewardSum += reward;
+
+            if (onEpisodeEnd){
+                onEpisodeEnd(suspended.episode, reward);
+            }
+
+            // The slot is refilled straight away, so the number of games in flight only falls at the very end
+            if (nextEpisode < lastEpisode){
+                start(suspended, nextEpisode++);
+            } else {
+                suspended.inFlight = false;
+                --inFlight;
+            }
+        }
+    }
+
+    return rewardSum;
+}
+
+int interleaving::InterleavedTrainer::getEpisodesInFlight() const{
+    return (int)slots.size();
+}
+
+void interleaving::InterleavedTrainer::start(SuspendedEpisode &suspended, long long episode){
+    // Dealing seeds the thread's generator, whose position is then kept with the episode until it is resumed
+    suspended.testEnvironment.reset(seed, (std::uint64_t)episode);
+    suspended.engine = environment::randomEngine();
+
+    agent.reset();
+    suspended.agentAction = suspended.agentDecision = agent.getAction();
+    suspended.episode = episode;
+    suspended.inFlight = true;
+}
+
+void interleaving::InterleavedTrainer::prefetch(const SuspendedEpisode &suspended) const{
+    const environment::GameState &state = suspended.testEnvironment.getState();
+    int playerTotal = state.getPlayerTotal(), faceupTotal = state.getFaceupTotal();
+
+    // Only unfinished games are in flight, but a total past the table would ask for a line outside it
+    if (playerTotal > environment::MAX_PLAYER_TOTAL || faceupTotal > environment::MAX_DEALER_SHOWING){
+        return;
+    }
+
+    int usableAce = state.doesPlayerHaveUsableAce();
+    const float *standValue = Q.getImage(playerTotal, faceupTotal, (int)environment::Action::STAND, usableAce);
+    const float *hitValue = Q.getImage(playerTotal, faceupTotal, (int)environment::Action::HIT, usableAce);
+
+    // Both actions usually share a line, but a table laid out differently would not have them side by side
+    prefetchLine(standValue);
+    prefetchLine(hitValue);
+}
+
+bool interleaving::InterleavedTrainer::resume(SuspendedEpisode &suspended){
+    std::swap(environment::randomEngine(), suspended.engine);
+    agent.resume(suspended.agentAction);
+
+    training::playRound(suspended.testEnvironment, agent, Q, suspended.visitedStatesAndActions, suspended.agentDecision);
+
+    suspended.agentAction = agent.getAction();
+    std::swap(environment::randomEngine(), suspended.engine);
+
+    return suspended.testEnvironment.getState().getOutcome() != environment::GameResult::UNFINISHED;
+}
@@ -0,0 +1,79 @@
+#pragma once
+
+#ifndef INTERLEAVING_H
+
+#define INTERLEAVING_H
+
+#include <vector>
+#include <cstdint>
+#include <functional>
+#include "training.hpp"
+
+namespace interleaving {
+
+    /* Enough games to cover a miss to main memory with the rounds of the others, few enough that they stay in cache */
+    const int DEFAULT_EPISODES_IN_FLIGHT = 16;
+
+    /* Called as each episode finishes, which is not in the order the episodes were started once several are in flight */
+    using EpisodeCallback = std::function<void(long long episode, float reward)>;
+
+    /*  Trains on many episodes at once on a single thread, taking one round of each game in turn.
+        Every game is a small state machine that is suspended between rounds: its environment, its recorded pairs,
+        the agent's choice and its own substream of the generator. Before a game is resumed the Q-Values of its
+        current state are prefetched, and the rounds of every other game in flight are played while they load,
+        so the wait for a table too large for the cache is overlapped rather than paid on every decision.
+
+        Episode e is still dealt and decided from substream e of the seed. With one episode in flight the
+        results are identical to playing the episodes one after another, with more the updates of the games
+        interleave, so a game may decide from values another game has not yet updated. */
+    class InterleavedTrainer {
+    public:
+        /* Q, the step sizes and the agent must outlive the trainer, the agent's exploration decays over every game */
+        InterleavedTrainer(
+            function::StateActionFunction &Q,
+            training::AdaptiveStepSize &stepSizes,
+            agents::GreedyAgent &agent,
+            std::uint64_t seed,
+            int episodesInFlight = DEFAULT_EPISODES_IN_FLIGHT,
+            environment::SteppingMode steppingMode = environment::SteppingMode::DECISION_POINTS
+        );
+
+        /* Plays and learns from episodes [firstEpisode, lastEpisode), returning the sum of their rewards */
+        double train(long long firstEpisode, long long lastEpisode, const EpisodeCallback &onEpisodeEnd = nullptr);
+
+        int getEpisodesInFlight() const;
+
+    private:
+        struct SuspendedEpisode {
+            environment::EnvironmentHandler testEnvironment;
+            std::vector<training::StateAndAction> visitedStatesAndActions;
+
+            /* The episode's substream, swapped into the thread's generator while the episode plays */
+            environment::RandomEngine engine;
+
+            /* The agent's choice and the last decision made in this game */
+            environment::Action agentAction, agentDecision;
+
+            long long episode = 0;
+            bool inFlight = false;
+        };
+
+        /* Deals the next episode into the slot */
+        void start(SuspendedEpisode &suspended, long long episode);
+
+        /* Asks for the cache lines the slot's next round will read */
+        void prefetch(const SuspendedEpisode &suspended) const;
+
+        /* Plays one round of the slot's game, returning whether the game is over */
+        bool resume(SuspendedEpisode &suspended);
+
+        function::StateActionFunction &Q;
+        training::AdaptiveStepSize &stepSizes;
+        agents::GreedyAgent &agent;
+        std::uint64_t seed;
+
+        std::vector<SuspendedEpisode> slots;
+    };
+}
+
+#endif /* INTERLEAVING_H */
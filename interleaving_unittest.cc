@@ -0,0 +1,97 @@
+#include <gtest/gtest.h>
+
+#include <cstring>
+#include <algorithm>
+
+#include "interleaving.hpp"
+#include "test_helpers.hpp"
+
+class InterleavingTests : public testing::Test {
+    protected:
+        test_helpers::SilencedNarration silenced;
+
+        InterleavingTests(){
+            visitedStatesAndActions.reserve(training::MAX_RECORDED_STATES);
+        }
+
+        /* Plays episodes first..last-1 of seed 7 one after another, recording each reward */
+        double playSerially(long long first, long long last, agents::GreedyAgent &agent, function::StateActionFunction &Q,
+            training::AdaptiveStepSize &stepSizes, std::vector<float> &rewards){
+            double rewardSum = 0.0;
+            for (long long i = first; i < last; ++i){
+                testEnvironment.reset(7, (std::uint64_t)i);
+                rewards[i - first] = training::playControlEpisode(testEnvironment, agent, Q, visitedStatesAndActions, stepSizes);
+                rewardSum += rewards[i - first];
+            }
+            return rewardSum;
+        }
+
+        environment::EnvironmentHandler testEnvironment;
+        std::vector<training::StateAndAction> visitedStatesAndActions;
+};
+
+TEST_F(InterleavingTests, OneEpisodeInFlightMatchesSerialTraining){
+    training::StepSizeConfig config;
+    config.schedule = training::StepSizeSchedule::HARMONIC;
+
+    agents::GreedyAgent serialAgent, interleavedAgent;
+    function::StateActionFunction serialQ, interleavedQ;
+    training::AdaptiveStepSize serialStepSizes(config), interleavedStepSizes(config);
+
+    std::vector<float> rewards(5000);
+    double serialRewards = playSerially(0, 5000, serialAgent, serialQ, serialStepSizes, rewards);
+
+    interleaving::InterleavedTrainer trainer(interleavedQ, interleavedStepSizes, interleavedAgent, 7, 1);
+    double interleavedRewards = trainer.train(0, 5000);
+
+    std::size_t tableBytes = sizeof(float);
+    for (int extent: function::FUNCTION_SHAPE){
+        tableBytes *= extent;
+    }
+
+    EXPECT_EQ(serialRewards, interleavedRewards);
+    EXPECT_EQ(0, std::memcmp(serialQ.data(), interleavedQ.data(), tableBytes));
+}
+
+TEST_F(InterleavingTests, EveryEpisodeFinishesOnce){
+    agents::GreedyAgent agent;
+    function::StateActionFunction Q;
+    training::AdaptiveStepSize stepSizes;
+
+    interleaving::InterleavedTrainer trainer(Q, stepSizes, agent, 7, 7);
+    EXPECT_EQ(7, trainer.getEpisodesInFlight());
+
+    std::vector<long long> finished;
+    double callbackRewards = 0.0;
+    double rewardSum = trainer.train(3, 103, [&](long long episode, float reward){
+        finished.push_back(episode);
+        callbackRewards += reward;
+    });
+
+    std::sort(finished.begin(), finished.end());
+    ASSERT_EQ(100u, finished.size());
+    for (long long i = 0; i < 100; ++i){
+        EXPECT_EQ(3 + i, finished[i]);
+    }
+    EXPECT_EQ(rewardSum, callbackRewards);
+}
+
+TEST_F(InterleavingTests, InterleavedEpisodesKeepTheirOwnSubstreams){
+    // A purely random agent on a table that never moves plays each episode the same however the rounds are ordered
+    training::StepSizeConfig config;
+    config.learningFactor = 0.0f;
+
+    agents::GreedyAgent serialAgent(1.0f, 1.0f), interleavedAgent(1.0f, 1.0f);
+    function::StateActionFunction serialQ, interleavedQ;
+    training::AdaptiveStepSize serialStepSizes(config), interleavedStepSizes(config);
+
+    std::vector<float> serialRewards(2000), interleavedRewards(2000);
+    playSerially(0, 2000, serialAgent, serialQ, serialStepSizes, serialRewards);
+
+    interleaving::InterleavedTrainer trainer(interleavedQ, interleavedStepSizes, interleavedAgent, 7, 16);
+    trainer.train(0, 2000, [&](long long episode, float reward){
+        interleavedRewards[episode] = reward;
+    });
+
+    EXPECT_EQ(serialRewards, interleavedRewards);
+}
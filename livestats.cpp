@@ -0,0 +1,199 @@
+#include "livestats.hpp"
+
+#include <new>
+#include <thread>
+#include <cstring>
+#include <iomanip>
+#include <algorithm>
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+std::string livestats::segmentName(const std::string &runName){
+    return SEGMENT_PREFIX + runName;
+}
+
+bool livestats::hasStalled(const LiveStats &latest, double secondsSinceLastPublication){
+    if (!latest.running){
+        return false;
+    }
+
+    // The rate is only known once a publication has measured it, until then only the minimum applies
+    double publishSeconds = latest.episodesPerSecond > 0.0 ? DEFAULT_PUBLISH_INTERVAL / latest.episodesPerSecond : 0.0;
+    return secondsSinceLastPublication > std::max(MINIMUM_STALL_SECONDS, STALLED_PUBLICATIONS * publishSeconds);
+}
+
+livestats::LiveStatsPublisher::LiveStatsPublisher(const std::string &runName) : name(segmentName(runName)), segment(nullptr) {
+    // A segment of the same name can only be left over from a killed run, and readers still attached to it keep it
+    shm_unlink(name.c_str());
+
+    // Readable by anyone, since the counters say nothing the run's own output would not
+    int descriptor = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0644);
+    if (descriptor < 0){
+        return;
+    }
+
+    void *memory = MAP_FAILED;
+    if (ftruncate(descriptor, sizeof(StatsSegment)) == 0){
+        memory = mmap(nullptr, sizeof(StatsSegment), PROT_READ | PROT_WRITE, MAP_SHARED, descriptor, 0);
+    }
+    close(descriptor);
+
+    if (memory == MAP_FAILED){
+        shm_unlink(name.c_str());
+        return;
+    }
+
+    segment = new (memory) StatsSegment();
+    if (!segment->sequence.is_lock_free() || !segment->magic.is_lock_free()){
+        segment->~StatsSegment();
+        munmap(memory, sizeof(StatsSegment));
+        shm_unlink(name.c_str());
+        segment = nullptr;
+        return;
+    }
+
+    segment->version = SEGMENT_VERSION;
+    segment->size = sizeof(StatsSegment);
+    segment->sequence.store(0, std::memory_order_relaxed);
+    for (std::atomic<std::uint64_t> &word: segment->words){
+        word.store(0, std::memory_order_relaxed);
+    }
+    segment->magic.store(SEGMENT_MAGIC, std::memory_order_release);
+}
+
+livestats::LiveStatsPublisher::~LiveStatsPublisher(){
+    if (segment == nullptr){
+        return;
+    }
+
+    shm_unlink(name.c_str());
+    segment->~StatsSegment();
+    munmap(segment, sizeof(StatsSegment));
+}
+
+bool livestats::LiveStatsPublisher::isOpen() const{
+    return segment != nullptr;
+}
+
+void livestats::LiveStatsPublisher::publish(const LiveStats &stats){
+    if (segment == nullptr){
+        return;
+    }
+
+    std::uint64_t words[STATS_WORDS] = {};
+    std::memcpy(words, &stats, sizeof(LiveStats));
+
+    // Odd while the words are being stored, and the fence keeps the stores after it
+    std::uint64_t sequence = segment->sequence.load(std::memory_order_relaxed);
+    segment->sequence.store(sequence + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    for (int i = 0; i < STATS_WORDS; ++i){
+        segment->words[i].store(words[i], std::memory_order_relaxed);
+    }
+
+    segment->sequence.store(sequence + 2, std::memory_order_release);
+}
+
+livestats::LiveStatsReader::LiveStatsReader(const std::string &runName) : segment(nullptr) {
+    int descriptor = shm_open(segmentName(runName).c_str(), O_RDONLY, 0);
+    if (descriptor < 0){
+        return;
+    }
+
+    // A segment of another size is from another layout, and mapping past its end would fault
+    struct stat status;
+    void *memory = MAP_FAILED;
+    if (fstat(descriptor, &status) == 0 && status.st_size == (off_t)sizeof(StatsSegment)){
+        memory = mmap(nullptr, sizeof(StatsSegment), PROT_READ, MAP_SHARED, descriptor, 0);
+    }
+    close(descriptor);
+
+    if (memory == MAP_FAILED){
+        return;
+    }
+
+    const StatsSegment *mapped = static_cast<const StatsSegment*>(memory);
+    if (mapped->magic.load(std::memory_order_acquire) != SEGMENT_MAGIC ||
+        mapped->version != SEGMENT_VERSION || mapped->size != sizeof(StatsSegment)){
+        munmap(memory, sizeof(StatsSegment));
+        return;
+    }
+
+    segment = mapped;
+}
+
+livestats::LiveStatsReader::~LiveStatsReader(){
+    if (segment != nullptr){
+        munmap(const_cast<StatsSegment*>(segment), sizeof(StatsSegment));
+    }
+}
+
+bool livestats::LiveStatsReader::isOpen() const{
+    return segment != nullptr;
+}
+
+bool livestats::LiveStatsReader::read(LiveStats &stats) const{
+    if (segment == nullptr){
+        return false;
+    }
+
+    std::uint64_t words[STATS_WORDS];
+
+    for (int attempt = 0; attempt < MAX_READ_ATTEMPTS; ++attempt){
+        std::uint64_t before = segment->sequence.load(std::memory_order_acquire);
+        if (before == 0){
+            return false;
+        }
+
+        if (before % 2 == 0){
+            for (int i = 0; i < STATS_WORDS; ++i){
+                words[i] = segment->words[i].load(std::memory_order_relaxed);
+            }
+
+            // Keeps the loads of the words before the second load of the sequence
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (segment->sequence.load(std::memory_order_relaxed) == before){
+                std::memcpy(&stats, words, sizeof(LiveStats));
+                return true;
+            }
+        }
+
+        std::this_thread::yield();
+    }
+
+    return false;
+}
+
+std::uint64_t livestats::LiveStatsReader::getPublications() const{
+    // Every publication advances the sequence by two, and an odd sequence is a publication being made
+    return segment != nullptr ? segment->sequence.load(std::memory_order_acquire) / 2 : 0;
+}
+
+std::ostream& operator<<(std::ostream& o, const livestats::LiveStats &s){
+    o << (s.running ? "Running" : "Finished") << ", " << s.episodesCompleted << " of " << s.numberOfEpisodes <<
+        " episodes in " << std::fixed << std::setprecision(1) << s.elapsedSeconds << " seconds (" <<
+        std::setprecision(0) << s.episodesPerSecond << " episodes per second)\n" <<
+        std::setprecision(5) << "Mean reward = " << s.meanReward << ", epsilon = " << s.epsilon << "\n" <<
+        "Current winnings = " << s.currentWinnings << ", highest winnings = " << s.highestWinnings << "\n" <<
+        std::defaultfloat;
+
+    if (s.phaseCalls[static_cast<int>(profiler::Phase::EPISODE)] == 0){
+        return o << "Phase timings are only recorded when built with BLACKJACK_ENABLE_PROFILER\n";
+    }
+
+    o << std::left << std::setw(16) << "phase" << std::right <<
+        std::setw(16) << "total (ms)" << std::setw(16) << "calls" << std::setw(12) << "ns/call" << "\n";
+
+    for (int i = 0; i < profiler::NUMBER_OF_PHASES; ++i){
+        o << std::left << std::setw(16) << profiler::Phase(i) << std::right << std::fixed << std::setprecision(2) <<
+            std::setw(16) << s.phaseNanoseconds[i] / 1e6 <<
+            std::setw(16) << s.phaseCalls[i] <<
+            std::setw(12) << (s.phaseCalls[i] ? s.phaseNanoseconds[i] / s.phaseCalls[i] : 0.0) << "\n";
+    }
+
+    return o << std::defaultfloat;
+}
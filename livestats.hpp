@@ -0,0 +1,129 @@
+#pragma once
+
+#ifndef LIVESTATS_H
+
+#define LIVESTATS_H
+
+#include <atomic>
+#include <string>
+#include <cstdint>
+#include <type_traits>
+#include "profiler.hpp"
+
+/*  Counters of a training run published in a small POSIX shared memory segment, so external tools such as
+    blackjack_stats can watch a long run without the run writing anything to a terminal or a file.
+    Linux only, like the multi-process trainer. */
+namespace livestats {
+
+    /* Identifies a segment of this layout, readers refuse any other */
+    const std::uint32_t SEGMENT_MAGIC = 0x54534A42; // "BJST"
+    const std::uint32_t SEGMENT_VERSION = 1;
+
+    /* A run named n publishes to /blackjack_stats_n */
+    const char SEGMENT_PREFIX[] = "/blackjack_stats_";
+
+    /* Episodes between two publications, rare enough that publishing costs nothing next to the episodes themselves */
+    const int DEFAULT_PUBLISH_INTERVAL = 10000;
+
+    /* Times a reader retries a read torn by the writer before giving up for now */
+    const int MAX_READ_ATTEMPTS = 64;
+
+    /* Publications a run may miss before a watcher reports it as stalled or gone */
+    const int STALLED_PUBLICATIONS = 5;
+
+    /* The shortest silence reported as a stall, so a run publishing many times a second is not reported over a hiccup */
+    const double MINIMUM_STALL_SECONDS = 10.0;
+
+    /* One consistent set of counters */
+    struct LiveStats {
+        std::uint64_t episodesCompleted = 0, numberOfEpisodes = 0;
+        double elapsedSeconds = 0.0;
+
+        /* Measured over the episodes since the previous publication */
+        double episodesPerSecond = 0.0;
+
+        double meanReward = 0.0;
+        std::int64_t currentWinnings = 0, highestWinnings = 0;
+        double epsilon = 0.0;
+
+        /* Zero unless the run was built with BLACKJACK_ENABLE_PROFILER */
+        double phaseNanoseconds[profiler::NUMBER_OF_PHASES] = {};
+        std::uint64_t phaseCalls[profiler::NUMBER_OF_PHASES] = {};
+
+        /* Cleared by the last publication of the run */
+        std::uint32_t running = 0;
+    };
+
+    static_assert(std::is_trivially_copyable<LiveStats>::value, "LiveStats is copied through the segment word by word");
+
+    const int STATS_WORDS = (int)((sizeof(LiveStats) + sizeof(std::uint64_t) - 1) / sizeof(std::uint64_t));
+
+    /*  The contents of the segment, guarded by a sequence lock. The single writer makes the sequence odd, stores the
+        words and makes it even again, and a reader keeps a copy only if it saw the same even sequence before and after
+        copying, so the writer never waits on a reader. The words are relaxed atomics, so a torn copy is never undefined
+        behaviour, only discarded. */
+    struct StatsSegment {
+        /* Stored last when the segment is created, so a reader never accepts a half initialised segment */
+        std::atomic<std::uint32_t> magic;
+        std::uint32_t version, size;
+
+        std::atomic<std::uint64_t> sequence;
+        std::atomic<std::uint64_t> words[STATS_WORDS];
+    };
+
+    /* The name of a run's segment */
+    std::string segmentName(const std::string &runName);
+
+    /*  Whether a run whose latest counters are these, and which has published nothing for the given seconds, has
+        stopped publishing: it missed STALLED_PUBLICATIONS publications at its last rate, and at least
+        MINIMUM_STALL_SECONDS passed. A finished run has not stalled. */
+    bool hasStalled(const LiveStats &latest, double secondsSinceLastPublication);
+
+    /*  Creates a run's segment, replacing any left behind by a run of the same name that was killed,
+        and removes it again when destroyed. A killed run never destroys its publisher, so its segment stays
+        until the next run of the same name. */
+    class LiveStatsPublisher {
+    public:
+        explicit LiveStatsPublisher(const std::string &runName);
+        ~LiveStatsPublisher();
+
+        LiveStatsPublisher(const LiveStatsPublisher&) = delete;
+        LiveStatsPublisher& operator=(const LiveStatsPublisher&) = delete;
+
+        /* False if the segment could not be created, in which case publish does nothing */
+        bool isOpen() const;
+
+        /* Called from one thread at a time, never blocks */
+        void publish(const LiveStats &stats);
+
+    private:
+        std::string name;
+        StatsSegment *segment;
+    };
+
+    /* Attaches read only to a run's segment, which stays readable after the run removes its name */
+    class LiveStatsReader {
+    public:
+        explicit LiveStatsReader(const std::string &runName);
+        ~LiveStatsReader();
+
+        LiveStatsReader(const LiveStatsReader&) = delete;
+        LiveStatsReader& operator=(const LiveStatsReader&) = delete;
+
+        /* False if there is no such segment or it has a different layout */
+        bool isOpen() const;
+
+        /* Copies the latest publication, returning false if none has been made or every attempt was torn */
+        bool read(LiveStats &stats) const;
+
+        /* The number of publications made so far, which stops growing when the run stops publishing */
+        std::uint64_t getPublications() const;
+
+    private:
+        const StatsSegment *segment;
+    };
+}
+
+std::ostream& operator<<(std::ostream& o, const livestats::LiveStats &s);
+
+#endif /* LIVESTATS_H */
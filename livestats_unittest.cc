@@ -0,0 +1,157 @@
+#include <gtest/gtest.h>
+
+#include <thread>
+#include <atomic>
+#include <memory>
+#include <unistd.h>
+
+#include "livestats.hpp"
+
+class LiveStatsTests : public testing::Test {
+    protected:
+        // Unique to the test process, so runs of the tests in parallel never share a segment
+        std::string runName = "unittest_" + std::to_string((long long)getpid());
+};
+
+TEST_F(LiveStatsTests, PublishedStatsAreReadBack){
+    livestats::LiveStatsPublisher publisher(runName);
+    ASSERT_TRUE(publisher.isOpen());
+
+    livestats::LiveStatsReader reader(runName);
+    ASSERT_TRUE(reader.isOpen());
+
+    // Nothing has been published yet
+    livestats::LiveStats stats;
+    EXPECT_FALSE(reader.read(stats));
+
+    livestats::LiveStats published;
+    published.episodesCompleted = 250000;
+    published.numberOfEpisodes = 1000000;
+    published.episodesPerSecond = 612345.5;
+    published.meanReward = -0.0421;
+    published.currentWinnings = -35;
+    published.highestWinnings = 1240;
+    published.epsilon = 0.01;
+    published.phaseNanoseconds[static_cast<int>(profiler::Phase::EPISODE)] = 4.5e8;
+    published.phaseCalls[static_cast<int>(profiler::Phase::EPISODE)] = 250000;
+    published.running = 1;
+    publisher.publish(published);
+
+    ASSERT_TRUE(reader.read(stats));
+    EXPECT_EQ(250000u, stats.episodesCompleted);
+    EXPECT_EQ(1000000u, stats.numberOfEpisodes);
+    EXPECT_DOUBLE_EQ(612345.5, stats.episodesPerSecond);
+    EXPECT_DOUBLE_EQ(-0.0421, stats.meanReward);
+    EXPECT_EQ(-35, stats.currentWinnings);
+    EXPECT_EQ(1240, stats.highestWinnings);
+    EXPECT_DOUBLE_EQ(0.01, stats.epsilon);
+    EXPECT_DOUBLE_EQ(4.5e8, stats.phaseNanoseconds[static_cast<int>(profiler::Phase::EPISODE)]);
+    EXPECT_EQ(250000u, stats.phaseCalls[static_cast<int>(profiler::Phase::EPISODE)]);
+    EXPECT_EQ(1u, stats.running);
+}
+
+TEST_F(LiveStatsTests, ReaderNeedsARunningPublisher){
+    EXPECT_FALSE(livestats::LiveStatsReader(runName).isOpen());
+
+    std::unique_ptr<livestats::LiveStatsReader> attached;
+    {
+        livestats::LiveStatsPublisher publisher(runName);
+        attached.reset(new livestats::LiveStatsReader(runName));
+
+        livestats::LiveStats published;
+        published.episodesCompleted = 7;
+        publisher.publish(published);
+    }
+
+    // The name is removed with the publisher, but a reader already attached can still read the last publication
+    EXPECT_FALSE(livestats::LiveStatsReader(runName).isOpen());
+
+    livestats::LiveStats stats;
+    ASSERT_TRUE(attached->read(stats));
+    EXPECT_EQ(7u, stats.episodesCompleted);
+}
+
+TEST_F(LiveStatsTests, StalledRunsAreToldApartFromSlowOnes){
+    livestats::LiveStatsPublisher publisher(runName);
+    livestats::LiveStatsReader reader(runName);
+    EXPECT_EQ(0u, reader.getPublications());
+
+    livestats::LiveStats published;
+    published.running = 1;
+    publisher.publish(published);
+    publisher.publish(published);
+    EXPECT_EQ(2u, reader.getPublications());
+
+    // Publishing every 10000 / 500 = 20 seconds, so a stall takes 5 missed publications
+    published.episodesPerSecond = 500.0;
+    EXPECT_FALSE(livestats::hasStalled(published, 99.0));
+    EXPECT_TRUE(livestats::hasStalled(published, 101.0));
+
+    // Publishing many times a second, or at a rate not measured yet, only the minimum applies
+    published.episodesPerSecond = 1e7;
+    EXPECT_FALSE(livestats::hasStalled(published, livestats::MINIMUM_STALL_SECONDS - 1.0));
+    EXPECT_TRUE(livestats::hasStalled(published, livestats::MINIMUM_STALL_SECONDS + 1.0));
+    published.episodesPerSecond = 0.0;
+    EXPECT_TRUE(livestats::hasStalled(published, livestats::MINIMUM_STALL_SECONDS + 1.0));
+
+    // A finished run has stopped publishing on purpose
+    published.running = 0;
+    EXPECT_FALSE(livestats::hasStalled(published, 1e6));
+}
+
+TEST_F(LiveStatsTests, ReadsAreNeverTorn){
+    const std::uint64_t numberOfPublications = 200000;
+
+    livestats::LiveStatsPublisher publisher(runName);
+    livestats::LiveStatsReader reader(runName);
+    ASSERT_TRUE(reader.isOpen());
+
+    std::atomic<bool> finished(false);
+    std::thread writer([&](){
+        livestats::LiveStats published;
+        for (std::uint64_t i = 1; i <= numberOfPublications; ++i){
+            // Every field holds i, so a copy mixing two publications has fields that disagree
+            published.episodesCompleted = published.numberOfEpisodes = i;
+            published.episodesPerSecond = published.meanReward = published.epsilon = published.elapsedSeconds = (double)i;
+            published.currentWinnings = published.highestWinnings = (std::int64_t)i;
+            for (int p = 0; p < profiler::NUMBER_OF_PHASES; ++p){
+                published.phaseNanoseconds[p] = (double)i;
+                published.phaseCalls[p] = i;
+            }
+            published.running = (std::uint32_t)i;
+
+            publisher.publish(published);
+        }
+        finished = true;
+    });
+
+    long long reads = 0;
+    std::uint64_t latest = 0;
+    livestats::LiveStats stats, torn;
+    bool consistent = true;
+
+    while (!finished.load() || latest < numberOfPublications){
+        if (!reader.read(stats)){
+            continue;
+        }
+        ++reads;
+
+        // Publications are seen in order and never mix two of them, the first that does is kept for the checks below
+        std::uint64_t i = stats.episodesCompleted;
+        consistent = i == stats.numberOfEpisodes && (double)i == stats.meanReward && (double)i == stats.elapsedSeconds &&
+            (std::int64_t)i == stats.highestWinnings && (double)i == stats.phaseNanoseconds[profiler::NUMBER_OF_PHASES - 1] &&
+            i == stats.phaseCalls[profiler::NUMBER_OF_PHASES - 1] && (std::uint32_t)i == stats.running && i >= latest;
+        if (!consistent){
+            torn = stats;
+            break;
+        }
+        latest = i;
+    }
+
+    // The writer never waits on the reader, so it finishes even when the reads stopped early
+    writer.join();
+
+    EXPECT_TRUE(consistent) << "read " << torn.episodesCompleted << " after " << latest;
+    EXPECT_GT(reads, 0);
+    EXPECT_EQ(numberOfPublications, latest);
+}
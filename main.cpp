@@ -1,103 +1,242 @@
+#include <atomic>
 #include <thread>
 #include <chrono>
+#include <string>
+#include <memory>
 
 #include "agents.hpp"
 #include "function.hpp"
+#include "profiler.hpp"
+#include "evaluation.hpp"
+#include "training.hpp"
+#include "writer.hpp"
+#include "snapshot.hpp"
+#include "multiprocess.hpp"
+#include "interleaving.hpp"
+#include "pipeline.hpp"
+#include "sampling.hpp"
+#include "livestats.hpp"
+#include "table.hpp"
+#include "bankroll.hpp"
+#include "trainer.hpp"
+#include "statistics.hpp"
 
 /* Just experimenting with macros for the enums */
 #define HIT environment::Action::HIT
 #define STAND environment::Action::STAND
 #define MAX_NUMBER_OF_SIMULATIONS 1000000
+
+/*  The fixed training run and evaluation played by --workload, which the profile-guided build is trained on.
+    Both are seeded, so every build of the same source reports the same expected return. */
+const int WORKLOAD_EPISODES = 1000000;
+const long long WORKLOAD_HANDS = 2000000;
+const std::uint64_t WORKLOAD_SEED = 20240611;
 using std::cout;
 using std::cin;
 using std::vector;
 using namespace std::chrono;
 
-/* Stores a snapshot of the game's state alongside the action taken while in it*/ 
-using StateAndAction = std::pair<environment::GameState, environment::Action>;
+using training::StateAndAction;
+using training::stateAndActionShouldBeRecorded;
 
 using namespace std::chrono;
 // using namespace environment;
 
-void updateQValues(
-     function::StateActionFunction &Q,
-    function::StateActionFunction &N, 
-    function::StateActionFunction &returnSums
-);
-
-/* Q-Value update function for control function */
 void updateQValues(
     function::StateActionFunction &Q,
-    std::vector<StateAndAction> &visitedStatesAndActions,
-    float G,
-    float learningFactor
+    const statistics::StateActionStatistics &returnStatistics
 );
 
-/* Extracts the game outcome and determines the reward value */
-float generateRewardValue(environment::GameResult outcome);
-
-/* 
- Takes a state and  whether it was visited with an action previously and determines whether it should be recorded.
- States (and their related actions therein) should only be recorded if:
-    * The state and action pair has not been visited previously
-    * The player total is greater than or equal to 12 as a score under 12 is impossible to go bust on,
-        so no agent decision is necessary,
-    * The dealer is only showing one card, as the agent can make no further decisions after the dealer starts to
-        reveal their hand,
- */
-bool stateAndActionShouldBeRecorded(environment::GameState state);
-
 void monteCarloPredict(
     int numberOfSimulations, 
     agents::PassiveAgent &agent, 
     std::vector<StateAndAction> &visitedStatesAndActions, 
-    function::StateActionFunction &N, 
-    function::StateActionFunction &returnSums
+    statistics::StateActionStatistics &returnStatistics, // Keeps the count, mean and spread of each pair's returns
+    std::uint64_t seed // Episode i is dealt from substream i of the seed
 );
 
 void monteCarloControl(
     int numberOfSimulations, 
-    agents::GreedyAgent &agent, 
-    function::StateActionFunction &Q, // Stores the utility for each of the state-action pairs 
-    std::vector<StateAndAction> &visitedStatesAndActions
+    trainer::Trainer &trainer, // Owns the Q-Values, the agent and the winnings of the run
+    writer::AsyncWriter &progressLog, // Takes the progress reports so the loop never waits on the terminal
+    snapshot::SnapshotPublisher &publisher, // Receives a copy of Q every DEFAULT_SNAPSHOT_INTERVAL episodes
+    livestats::LiveStatsPublisher *liveStats // Receives the run's counters every DEFAULT_PUBLISH_INTERVAL episodes, if given
 );
 
 void runEpisode(
     agents::PassiveAgent &agent, 
     environment::GameState &state, 
     environment::EnvironmentHandler &testEnvironment,    
-    std::vector<StateAndAction> &visitedStatesAndActions, 
-    function::StateActionFunction &N
+    std::vector<StateAndAction> &visitedStatesAndActions
 );
 
-void updateReturnSums(
+void updateReturnStatistics(
     environment::GameState &state, 
     std::vector<StateAndAction> &visitedStatesAndActions, 
-    function::StateActionFunction &returnSums
+    statistics::StateActionStatistics &returnStatistics
 );
 
 void outputValueFunction(
-    function::StateActionFunction &Q
+    const function::StateActionFunction &Q
 );
 
-/* Stores the agents initial sum */
-long long currentWinnings = 1000;
-/* Stores the lowest winings ever received*/
-long long highestWinnings = 0;
-/* Stores the total rreward value across the entire simulation */
-double cumulativeReward = 0.0;
+/*  Options given on the command line:
+        --checkpoint <file>             Writes the trained Q-Values to file after training
+        --evaluate <passive|file>       Evaluates the passive agent or the greedy policy of a checkpoint instead of training
+        --hands <n>                     The most hands an evaluation plays
+        --width <w>                     Stops an evaluation once its 95% interval is narrower than w
+        --threads <n>                   Evaluation threads, every hardware thread by default
+        --compare <passive|file>        Compares against the --evaluate policy on the same recorded hands
+        --stream <file>                 Replays the hands of a recorded card stream when comparing,
+                                        recording --hands new hands into it if it cannot be loaded
+        --seed <n>                      Seeds every episode's substream, the current time by default
+        --live-evaluation <n>           Evaluates each published snapshot of the Q-Values on n hands while training continues
+        --step-size <schedule>          constant (0.001), harmonic (1/N), polynomial (1/N^0.75) or floor (decays to 0.001),
+                                        where N counts the visits to each state-action pair
+        --processes <n>                 Trains in n forked worker processes over a shared memory Q table,
+                                        checkpointing it every second when --checkpoint is given
+        --interleave <n>                Trains on n episodes at once, taking a round of each in turn,
+                                        so the Q-Values of one can load while the others play
+        --stepping <rounds|decisions>   Whether a training step plays one round, or by default runs on to the next decision,
+                                        hitting below 12 and playing out the dealer without asking the agent
+        --starts <natural|exploring|prioritised>
+                                        Whether training episodes are dealt, or start from a decision state and first action
+                                        drawn uniformly, so every state-action pair is visited, or drawn in proportion to
+                                        the uncertainty of the pair's return (one episode at a time)
+        --workload <n>                  Plays the built-in training and evaluation workload n times, reporting the fastest run
+        --producers <n>                 Trains with n threads simulating episodes and passing them to the learner threads
+        --learners <n>                  The threads applying the producers' episodes to Q, 1 by default
+        --live-stats <name>             Publishes the counters of the training run in shared memory for blackjack_stats <name>
+        --seats <n>                     Evaluates a checkpoint at n seats of a table sharing one shoe, playing --hands hands
+        --decks <n>                     The decks in the table's shoe, 6 by default
+        --sessions <n>                  Bets n sessions of 1000 on a checkpoint's policy from a stream of --hands recorded hands
+                                        and outputs its risk of ruin
+        --session-hands <n>             The most hands a session lasts, 1000 by default
+        --bet <flat|proportional|kelly> Whether a session bets 5 a hand, 1% of its bankroll or half the Kelly share of it
+        --action-values <n>             Plays a checkpoint's policy for n hands and outputs the mean return of every
+                                        state-action pair it takes with its 95% interval
+        --trainers <n>                  Trains n independent runs side by side on --threads threads, run t with seed + t,
+                                        checkpointing run t to <file>.t when --checkpoint is given
+    Without --evaluate the interactive training run is used. */
+struct RunOptions {
+    std::string checkpointPath, evaluationTarget, comparisonTarget, streamPath;
+
+    /* The name the training run's counters are published under, empty publishes nothing */
+    std::string liveStatsName;
+
+    /* Seats of the table an evaluation is played at, 0 plays one hand at a time from a fresh deck */
+    int numberOfSeats = 0;
+    table::TableConfig tableConfig;
+    evaluation::EvaluationConfig evaluationConfig;
+
+    /* Hands played to estimate the return of each pair the evaluated policy takes, 0 evaluates its expected return instead */
+    long long actionValueEpisodes = 0;
+
+    /* Betting sessions played on the evaluated policy, 0 evaluates its expected return instead */
+    long long numberOfSessions = 0;
+    bankroll::BankrollConfig bankrollConfig;
+
+    /* Hands played on each snapshot by the live evaluation thread, 0 disables it */
+    long long liveEvaluationHands = 0;
+
+    training::StepSizeConfig stepSizeConfig;
+
+    /* Worker processes for multi-process training, 0 trains in this process */
+    int numberOfProcesses = 0;
+
+    /* Episodes in flight on the training thread, 1 plays them one after another */
+    int episodesInFlight = 1;
+
+    /* Simulation and learning threads of a pipelined run, which is only used with at least one producer */
+    int numberOfProducers = 0, numberOfLearners = 1;
+
+    /* Independent training runs trained concurrently, 1 trains the interactive run */
+    int numberOfTrainers = 1;
+
+    /* Runs of the built-in workload, 0 runs the interactive training instead */
+    int workloadRuns = 0;
+
+    /* How training episodes are stepped, evaluations always skip the forced rounds */
+    environment::SteppingMode steppingMode = environment::SteppingMode::DECISION_POINTS;
+
+    /* Whether training episodes start from a natural deal or from a drawn decision state and first action */
+    training::StartMode startMode = training::StartMode::NATURAL;
+
+    /* A run with the same seed and options gives identical results on any number of threads */
+    std::uint64_t seed = (std::uint64_t)time(0);
+};
+
+/* Returns false if an option is unknown or missing its value */
+bool parseArguments(int argc, char* argv[], RunOptions &options);
+
+/* Evaluates a fixed policy in parallel and outputs its expected return with a confidence interval */
+int runEvaluation(const RunOptions &options);
+
+/* Plays two fixed policies on the same recorded hands and outputs their paired difference */
+int runComparison(const RunOptions &options);
+
+/* Plays a checkpoint's greedy policy at every seat of a table sharing one shoe and outputs its expected return */
+int runTableEvaluation(const RunOptions &options);
+
+/* Plays a checkpoint's greedy policy across threads and outputs the mean return and interval of every pair it takes */
+int runActionValueEstimation(const RunOptions &options);
+
+/* Bets many sessions on a checkpoint's greedy policy and outputs its risk of ruin and the spread of its final bankrolls */
+int runBankrollSimulation(const RunOptions &options);
+
+/* Trains across forked worker processes that share one Q table and outputs the resulting policy */
+int runMultiProcessTraining(const RunOptions &options, long long numberOfEpisodes);
+
+/* Trains with producer threads simulating episodes and learner threads applying them, then reports the queue metrics */
+int runPipelineTraining(const RunOptions &options, long long numberOfEpisodes);
+
+/* Trains independent runs on a pool of threads and outputs the results of each */
+int runConcurrentTraining(const RunOptions &options, long long numberOfEpisodes);
+
+/*  Trains on the fixed workload and evaluates the greedy policy single threaded, so the time measures the code rather
+    than the number of cores. Used to generate the profile of the optimised build and to measure its speed-up. */
+int runWorkload(const RunOptions &options);
+
+/*  Evaluates the greedy policy of every new snapshot until training has finished,
+    reporting each result through the progress log so neither thread waits on the other */
+void runLiveEvaluation(
+    const RunOptions &options,
+    const snapshot::SnapshotPublisher &publisher,
+    const std::atomic<bool> &trainingFinished,
+    writer::AsyncWriter &progressLog
+);
 
-int COUNT = 0;
+/* The training run the options describe */
+trainer::TrainerConfig trainerConfig(const RunOptions &options);
 
-std::string confirmation;
+/*  Creates the agent for an evaluation target, either "passive" or the path of a checkpoint.
+    A checkpoint's greedy policy is stored in frozenPolicy, which must outlive the factory. */
+bool createAgentFactory(const std::string &target, policy::FrozenPolicy &frozenPolicy, evaluation::AgentFactory &createAgent);
 
-int main() {
+int main(int argc, char* argv[]) {
     std::ios_base::sync_with_stdio(false);
 
-    srand((unsigned int)time(0));
+    RunOptions options;
+    if (!parseArguments(argc, argv, options)){
+        std::cerr << "Usage: " << argv[0] << " [--checkpoint file] [--evaluate passive|file] [--hands n] [--width w] [--threads n]"
+            " [--compare passive|file] [--stream file] [--seed n] [--live-evaluation n]"
+            " [--step-size constant|harmonic|polynomial|floor] [--processes n] [--interleave n] [--producers n] [--learners n]"
+            " [--workload n] [--stepping rounds|decisions] [--starts natural|exploring|prioritised] [--live-stats name]"
+            " [--seats n] [--decks n] [--sessions n] [--session-hands n] [--bet flat|proportional|kelly] [--trainers n]"
+            " [--action-values n]\n";
+        return 1;
+    }
+
+    srand((unsigned int)options.seed);
+
+    if (!options.evaluationTarget.empty()){
+        return runEvaluation(options);
+    }
+
+    if (options.workloadRuns > 0){
+        return runWorkload(options);
+    }
 
-    function::StateActionFunction Q, N, returnSums;
-    
     cout << "Enter the number of simulations: ";
     int numberOfSimulations;
     cin >> numberOfSimulations;
@@ -106,24 +245,67 @@ int main() {
     // Disable output
     cout.setstate(std::ios_base::failbit);
 
+    // Long runs are what the worker processes and the pipeline are for, so they are not limited to a million episodes
+    if (options.numberOfProcesses > 0){
+        return runMultiProcessTraining(options, std::max(1, numberOfSimulations));
+    }
+
+    if (options.numberOfProducers > 0){
+        return runPipelineTraining(options, std::max(1, numberOfSimulations));
+    }
+
     // Clips the number of simulations to be between one and one million
     numberOfSimulations = std::max(1, std::min(numberOfSimulations, MAX_NUMBER_OF_SIMULATIONS));
 
-    // Initialise the passive agent
-    // agents::PassiveAgent agent;
+    if (options.numberOfTrainers > 1){
+        return runConcurrentTraining(options, numberOfSimulations);
+    }
 
-    // Initialise the greedy agent with epsilon = 1 and decay rate of 0.999
-    agents::GreedyAgent agent;
-    
-    vector<StateAndAction> visitedStatesAndActions;
+    // The greedy agent starts with epsilon = 1 and a decay rate of 0.999
+    trainer::Trainer trainer(trainerConfig(options));
 
-    // monteCarloPredict(numberOfSimulations, agent, visitedStatesAndActions, stateActionVisited, N, returnSums);
-    monteCarloControl(numberOfSimulations, agent, Q, visitedStatesAndActions);
+    // Progress is written to clog from a separate thread while training runs
+    writer::AsyncWriter progressLog(std::clog);
+
+    // Snapshots of Q can be evaluated while training carries on updating it
+    snapshot::SnapshotPublisher publisher;
+    std::atomic<bool> trainingFinished(false);
+    std::thread liveEvaluator;
+
+    if (options.liveEvaluationHands > 0){
+        liveEvaluator = std::thread(
+            runLiveEvaluation, std::cref(options), std::cref(publisher), std::cref(trainingFinished), std::ref(progressLog)
+        );
+    }
+
+    // Outlives the run's final publication, and removes the segment once the results are out
+    std::unique_ptr<livestats::LiveStatsPublisher> liveStats;
+    if (!options.liveStatsName.empty()){
+        liveStats.reset(new livestats::LiveStatsPublisher(options.liveStatsName));
+        if (!liveStats->isOpen()){
+            std::cerr << "Live statistics could not be published as " << livestats::segmentName(options.liveStatsName) << "\n";
+            liveStats.reset();
+        }
+    }
+
+    // monteCarloPredict(numberOfSimulations, agent, visitedStatesAndActions, returnStatistics, options.seed);
+    monteCarloControl(numberOfSimulations, trainer, progressLog, publisher, liveStats.get());
+
+    trainingFinished = true;
+    if (liveEvaluator.joinable()){
+        liveEvaluator.join();
+    }
+
+    // Let every report reach the terminal before the results are printed after them
+    progressLog.flush();
 
 
     /* Re-enables output */ 
     cout.clear();
 
+    const function::StateActionFunction &Q = trainer.getQ();
+    const trainer::TrainerStats &stats = trainer.getStats();
+
     cout << "Now outputting max utility of each state\n\n";
 
     outputValueFunction(Q);
@@ -131,62 +313,565 @@ int main() {
     cout << "\n\nNow outputting the value of Q\n";
     cout << Q << "\n\n";
 
-    cout << "Final winnings = " << currentWinnings << "\n";
-    cout << "Highest winnings = " << highestWinnings << "\n";
-    cout << "Expected reward = " << cumulativeReward / numberOfSimulations << "\n";
-    cout << COUNT << " states were visited more than once.\n";
+    cout << "Now outputting the greedy policy (H = hit, S = stand)\n";
+    cout << policy::FrozenPolicy::fromFunction(Q) << "\n";
 
-    // /* Prints the visit counts for each state action pair */
-    // cout << "Now printing State-Action visit counts\n"; 
-    // cout << N << "\n";
+    cout << "Final winnings = " << stats.currentWinnings << "\n";
+    cout << "Highest winnings = " << stats.highestWinnings << "\n";
+    cout << "Expected reward = " << stats.cumulativeReward / numberOfSimulations << "\n";
+    cout << "Seed = " << options.seed << "\n";
 
-    // cout << "Now printing the calculated return sums for each state and action\n";
-    // /* Prints the return sums for each state action pair */
-    // cout << returnSums << "\n";
+    if (!options.checkpointPath.empty()){
+        if (Q.saveToFile(options.checkpointPath)){
+            cout << "Q-Values saved to " << options.checkpointPath << "\n";
+        } else {
+            std::cerr << "Q-Values could not be saved to " << options.checkpointPath << "\n";
+        }
+    }
+
+#ifdef BLACKJACK_PROFILE
+    profiler::report(std::clog);
+#endif
+
+    // /* Prints the mean return, interval and visit count of each state action pair */
+    // cout << "Now printing the return statistics for each state and action\n";
+    // cout << returnStatistics << "\n";
 
     // // Update q vales below here
     // cout << "Now updating Q-Values \n";
-    // updateQValues(Q, N, returnSums);
+    // updateQValues(Q, returnStatistics);
     // cout << "\n\n";
     // cout << Q << "\n";
 
     return 0;
 }
 
-void updateQValues( 
-    function::StateActionFunction &Q,
-    function::StateActionFunction &N, 
-    function::StateActionFunction &returnSums
+bool parseArguments(int argc, char* argv[], RunOptions &options){
+    for (int i = 1; i < argc; ++i){
+        std::string option(argv[i]);
+
+        // Every option takes a value
+        if (i + 1 >= argc){
+            return false;
+        }
+        std::string value(argv[++i]);
+
+        try {
+            if (option == "--checkpoint"){
+                options.checkpointPath = value;
+            } else if (option == "--evaluate"){
+                options.evaluationTarget = value;
+            } else if (option == "--hands"){
+                options.evaluationConfig.maxHands = std::max(1LL, std::stoll(value));
+            } else if (option == "--width"){
+                options.evaluationConfig.targetWidth = std::stod(value);
+            } else if (option == "--threads"){
+                options.evaluationConfig.numberOfThreads = std::stoi(value);
+            } else if (option == "--compare"){
+                options.comparisonTarget = value;
+            } else if (option == "--stream"){
+                options.streamPath = value;
+            } else if (option == "--live-stats"){
+                options.liveStatsName = value;
+            } else if (option == "--seats"){
+                options.numberOfSeats = std::max(1, std::min(std::stoi(value), table::MAX_SEATS));
+            } else if (option == "--decks"){
+                options.tableConfig.numberOfDecks = std::max(1, std::stoi(value));
+            } else if (option == "--sessions"){
+                options.numberOfSessions = std::max(1LL, std::stoll(value));
+            } else if (option == "--session-hands"){
+                options.bankrollConfig.handsPerSession = std::max(1, std::stoi(value));
+            } else if (option == "--bet"){
+                if (value == "flat"){
+                    options.bankrollConfig.sizing = bankroll::BetSizing::FLAT;
+                } else if (value == "proportional"){
+                    options.bankrollConfig.sizing = bankroll::BetSizing::PROPORTIONAL;
+                } else if (value == "kelly"){
+                    options.bankrollConfig.sizing = bankroll::BetSizing::KELLY;
+                } else {
+                    return false;
+                }
+            } else if (option == "--seed"){
+                options.seed = std::stoull(value);
+            } else if (option == "--live-evaluation"){
+                options.liveEvaluationHands = std::max(0LL, std::stoll(value));
+            } else if (option == "--step-size"){
+                if (value == "constant"){
+                    options.stepSizeConfig.schedule = training::StepSizeSchedule::CONSTANT;
+                } else if (value == "harmonic"){
+                    options.stepSizeConfig.schedule = training::StepSizeSchedule::HARMONIC;
+                } else if (value == "polynomial"){
+                    options.stepSizeConfig.schedule = training::StepSizeSchedule::POLYNOMIAL;
+                } else if (value == "floor"){
+                    options.stepSizeConfig.schedule = training::StepSizeSchedule::FLOOR_DECAY;
+                } else {
+                    return false;
+                }
+            } else if (option == "--processes"){
+                options.numberOfProcesses = std::max(0, std::stoi(value));
+            } else if (option == "--interleave"){
+                options.episodesInFlight = std::max(1, std::stoi(value));
+            } else if (option == "--producers"){
+                options.numberOfProducers = std::max(0, std::stoi(value));
+            } else if (option == "--learners"){
+                options.numberOfLearners = std::max(1, std::stoi(value));
+            } else if (option == "--stepping"){
+                if (value == "rounds"){
+                    options.steppingMode = environment::SteppingMode::EVERY_ROUND;
+                } else if (value == "decisions"){
+                    options.steppingMode = environment::SteppingMode::DECISION_POINTS;
+                } else {
+                    return false;
+                }
+            } else if (option == "--starts"){
+                if (value == "natural"){
+                    options.startMode = training::StartMode::NATURAL;
+                } else if (value == "exploring"){
+                    options.startMode = training::StartMode::EXPLORING;
+                } else if (value == "prioritised"){
+                    options.startMode = training::StartMode::PRIORITISED;
+                } else {
+                    return false;
+                }
+            } else if (option == "--action-values"){
+                options.actionValueEpisodes = std::max(1LL, std::stoll(value));
+            } else if (option == "--trainers"){
+                options.numberOfTrainers = std::max(1, std::stoi(value));
+            } else if (option == "--workload"){
+                options.workloadRuns = std::max(1, std::stoi(value));
+            } else {
+                return false;
+            }
+        } catch (const std::exception&) {
+            // The value of a numeric option was not a number
+            return false;
+        }
+    }
+
+    // The worker processes and the pipeline deal every episode naturally and publish no snapshots, so neither can honour these
+    bool multiProcessOrPipeline = options.numberOfProcesses > 0 || options.numberOfProducers > 0;
+    if (multiProcessOrPipeline && (options.startMode != training::StartMode::NATURAL || options.liveEvaluationHands > 0)){
+        return false;
+    }
+
+    // Only a single run in this process publishes live statistics, and a watcher would wait forever for any other
+    if (!options.liveStatsName.empty() && (multiProcessOrPipeline || options.numberOfTrainers > 1)){
+        return false;
+    }
+
+    options.evaluationConfig.seed = options.seed;
+    options.bankrollConfig.numberOfSessions = options.numberOfSessions;
+    options.bankrollConfig.seed = options.seed;
+    options.bankrollConfig.numberOfThreads = options.evaluationConfig.numberOfThreads;
+    return true;
+}
+
+int runMultiProcessTraining(const RunOptions &options, long long numberOfEpisodes){
+    multiprocess::MultiProcessConfig config;
+    config.numberOfEpisodes = numberOfEpisodes;
+    config.numberOfWorkers = options.numberOfProcesses;
+    config.seed = options.seed;
+    config.stepSizeConfig = options.stepSizeConfig;
+    config.steppingMode = options.steppingMode;
+    config.checkpointPath = options.checkpointPath;
+
+    function::StateActionFunction Q;
+
+    auto start = high_resolution_clock::now();
+
+    multiprocess::MultiProcessResult result = multiprocess::train(config, Q);
+
+    auto duration = duration_cast<milliseconds>(high_resolution_clock::now() - start);
+
+    /* Re-enables output */
+    cout.clear();
+
+    if (!result.succeeded){
+        std::cerr << "The worker processes or their shared memory could not be set up\n";
+        return 1;
+    }
+
+    cout << "Now outputting the greedy policy (H = hit, S = stand)\n";
+    cout << policy::FrozenPolicy::fromFunction(Q) << "\n";
+
+    cout << result.episodesCompleted << " episodes completed by " << options.numberOfProcesses << " processes in " <<
+        duration.count() << " milliseconds\n";
+    cout << "Workers restarted after crashing = " << result.workersRestarted << "\n";
+    cout << "Expected reward = " << result.rewardSum / (double)std::max(1LL, result.episodesCompleted) << "\n";
+    cout << "Seed = " << options.seed << "\n";
+
+    if (!options.checkpointPath.empty()){
+        cout << result.checkpointsWritten << " checkpoints written to " << options.checkpointPath << "\n";
+    }
+
+    return 0;
+}
+
+int runPipelineTraining(const RunOptions &options, long long numberOfEpisodes){
+    pipeline::PipelineConfig config;
+    config.numberOfEpisodes = numberOfEpisodes;
+    config.numberOfProducers = options.numberOfProducers;
+    config.numberOfLearners = options.numberOfLearners;
+    config.seed = options.seed;
+    config.stepSizeConfig = options.stepSizeConfig;
+    config.steppingMode = options.steppingMode;
+
+    function::StateActionFunction Q;
+
+    pipeline::PipelineStats stats = pipeline::train(config, Q);
+
+    /* Re-enables output */
+    cout.clear();
+
+    cout << "Now outputting the greedy policy (H = hit, S = stand)\n";
+    cout << policy::FrozenPolicy::fromFunction(Q) << "\n";
+
+    cout << options.numberOfProducers << " producers and " << options.numberOfLearners << " learners\n";
+    cout << stats;
+    cout << "Seed = " << options.seed << "\n";
+
+    if (!options.checkpointPath.empty()){
+        if (Q.saveToFile(options.checkpointPath)){
+            cout << "Q-Values saved to " << options.checkpointPath << "\n";
+        } else {
+            std::cerr << "Q-Values could not be saved to " << options.checkpointPath << "\n";
+        }
+    }
+
+    return 0;
+}
+
+int runConcurrentTraining(const RunOptions &options, long long numberOfEpisodes){
+    std::vector<std::unique_ptr<trainer::Trainer>> trainers;
+    for (int t = 0; t < options.numberOfTrainers; ++t){
+        trainer::TrainerConfig config = trainerConfig(options);
+        config.seed = options.seed + (std::uint64_t)t;
+        trainers.emplace_back(new trainer::Trainer(config));
+    }
+
+    auto start = high_resolution_clock::now();
+    trainer::trainConcurrently(trainers, numberOfEpisodes, options.evaluationConfig.numberOfThreads);
+    auto duration = duration_cast<milliseconds>(high_resolution_clock::now() - start);
+
+    /* Re-enables output */
+    cout.clear();
+
+    cout << "Trained " << trainers.size() << " runs of " << numberOfEpisodes << " episodes in " << duration.count() << " milliseconds\n";
+
+    for (int t = 0; t < (int)trainers.size(); ++t){
+        const trainer::TrainerStats &stats = trainers[t]->getStats();
+
+        cout << "Run " << t << ": seed = " << trainers[t]->getConfig().seed <<
+            ", expected reward = " << stats.cumulativeReward / (double)stats.episodesCompleted <<
+            ", final winnings = " << stats.currentWinnings << ", highest winnings = " << stats.highestWinnings << "\n";
+
+        if (!options.checkpointPath.empty()){
+            std::string path = options.checkpointPath + "." + std::to_string(t);
+            if (!trainers[t]->getQ().saveToFile(path)){
+                std::cerr << "Q-Values could not be saved to " << path << "\n";
+            }
+        }
+    }
+
+    return 0;
+}
+
+int runWorkload(const RunOptions &options){
+    evaluation::EvaluationConfig evaluationConfig;
+    evaluationConfig.maxHands = WORKLOAD_HANDS;
+    evaluationConfig.numberOfThreads = 1;
+    evaluationConfig.seed = WORKLOAD_SEED;
+
+    // The progress reports are part of the work being measured, but not worth showing
+    std::ostream discarded(nullptr);
+
+    long long fastest = 0;
+    evaluation::EvaluationResult result{};
+
+    for (int run = 1; run <= options.workloadRuns; ++run){
+        auto start = high_resolution_clock::now();
+
+        cout.setstate(std::ios_base::failbit);
+        {
+            trainer::TrainerConfig config;
+            config.seed = WORKLOAD_SEED;
+            config.stepSizeConfig = options.stepSizeConfig;
+            config.steppingMode = options.steppingMode;
+            trainer::Trainer trainer(config);
+
+            writer::AsyncWriter progressLog(discarded);
+            snapshot::SnapshotPublisher publisher;
+
+            monteCarloControl(WORKLOAD_EPISODES, trainer, progressLog, publisher, nullptr);
+
+            policy::FrozenPolicy frozenPolicy = policy::FrozenPolicy::fromFunction(trainer.getQ());
+            result = evaluation::evaluate(frozenPolicy, evaluationConfig);
+        }
+        cout.clear();
+
+        long long elapsed = duration_cast<milliseconds>(high_resolution_clock::now() - start).count();
+        fastest = run == 1 ? elapsed : std::min(fastest, elapsed);
+
+        cout << "Workload run " << run << " completed in " << elapsed << " milliseconds\n";
+    }
+
+    cout << "Expected return of the trained policy = " << result.expectedReturn << "\n";
+    cout << "Fastest workload run = " << fastest << " milliseconds\n";
+
+    return 0;
+}
+
+void runLiveEvaluation(
+    const RunOptions &options,
+    const snapshot::SnapshotPublisher &publisher,
+    const std::atomic<bool> &trainingFinished,
+    writer::AsyncWriter &progressLog
 ){
-        
-    float *visitCountPtr = nullptr,
-          *QValuePtr = nullptr,
-          *returnSumPtr = nullptr;
-
-    auto pointersAreValid = [&](){
-        return  (
-            visitCountPtr != nullptr && 
-            QValuePtr != nullptr &&
-            returnSumPtr != nullptr
+    evaluation::EvaluationConfig config = options.evaluationConfig;
+    config.maxHands = options.liveEvaluationHands;
+    config.targetWidth = 0.0;
+    config.numberOfThreads = 1;
+
+    long long evaluatedVersion = 0;
+
+    while (!trainingFinished){
+        if (publisher.getVersion() == evaluatedVersion){
+            std::this_thread::sleep_for(milliseconds(10));
+            continue;
+        }
+
+        // The snapshot cannot change while it is held, however far training gets in the meantime
+        std::shared_ptr<const snapshot::Snapshot> latest = publisher.acquire();
+        evaluatedVersion = latest->version;
+
+        evaluation::EvaluationResult result = evaluation::evaluate(policy::FrozenPolicy::fromFunction(latest->Q), config);
+
+        progressLog.tryWrite(
+            "Live evaluation after " + std::to_string(latest->episodes) + " episodes: expected return = " +
+            std::to_string(result.expectedReturn) + ", 95% confidence interval = [" +
+            std::to_string(result.lowerBound) + ", " + std::to_string(result.upperBound) + "]\n\n"
         );
+    }
+}
+
+trainer::TrainerConfig trainerConfig(const RunOptions &options){
+    trainer::TrainerConfig config;
+    config.seed = options.seed;
+    config.stepSizeConfig = options.stepSizeConfig;
+    config.episodesInFlight = options.episodesInFlight;
+    config.steppingMode = options.steppingMode;
+    config.startMode = options.startMode;
+    return config;
+}
+
+bool createAgentFactory(const std::string &target, policy::FrozenPolicy &frozenPolicy, evaluation::AgentFactory &createAgent){
+    if (target == "passive"){
+        createAgent = [](){
+            return std::unique_ptr<agents::Agent>(new agents::PassiveAgent());
+        };
+        return true;
+    }
+
+    function::StateActionFunction Q;
+    if (!Q.loadFromFile(target)){
+        std::cerr << "Q-Values could not be loaded from " << target << "\n";
+        return false;
+    }
+
+    frozenPolicy = policy::FrozenPolicy::fromFunction(Q);
+    createAgent = [&frozenPolicy](){
+        return std::unique_ptr<agents::Agent>(new agents::PolicyAgent(frozenPolicy));
     };
+    return true;
+}
+
+int runEvaluation(const RunOptions &options){
+    if (!options.comparisonTarget.empty()){
+        return runComparison(options);
+    }
+
+    if (options.actionValueEpisodes > 0){
+        return runActionValueEstimation(options);
+    }
+
+    if (options.numberOfSessions > 0){
+        return runBankrollSimulation(options);
+    }
+
+    if (options.numberOfSeats > 0){
+        return runTableEvaluation(options);
+    }
+
+    policy::FrozenPolicy frozenPolicy;
+    evaluation::AgentFactory createAgent;
+
+    if (!createAgentFactory(options.evaluationTarget, frozenPolicy, createAgent)){
+        return 1;
+    }
+
+    // Disable the per-round output of the environment and agents while the hands are played
+    cout.setstate(std::ios_base::failbit);
+
+    auto start = high_resolution_clock::now();
+
+    evaluation::EvaluationResult result = evaluation::evaluate(createAgent, options.evaluationConfig);
+
+    auto duration = duration_cast<milliseconds>(high_resolution_clock::now() - start);
+
+    /* Re-enables output */
+    cout.clear();
+
+    cout << "Evaluated " << options.evaluationTarget << " with seed " << options.seed << " in " << duration.count() << " milliseconds\n";
+    cout << result;
+
+    return 0;
+}
+
+int runTableEvaluation(const RunOptions &options){
+    policy::FrozenPolicy frozenPolicy;
+    evaluation::AgentFactory createAgent;
+
+    // The passive agent decides at random, and seats only play policies that decide on totals alone
+    if (options.evaluationTarget == "passive"){
+        std::cerr << "Only the greedy policy of a checkpoint can be played at a table\n";
+        return 1;
+    }
+    if (!createAgentFactory(options.evaluationTarget, frozenPolicy, createAgent)){
+        return 1;
+    }
+
+    table::TableConfig config = options.tableConfig;
+    config.seed = options.seed;
+
+    long long numberOfRounds = (options.evaluationConfig.maxHands + options.numberOfSeats - 1) / options.numberOfSeats;
+
+    auto start = high_resolution_clock::now();
+    table::TableStats stats = table::simulate(frozenPolicy, options.numberOfSeats, numberOfRounds, config);
+    auto duration = duration_cast<milliseconds>(high_resolution_clock::now() - start);
+
+    cout << "Evaluated " << options.evaluationTarget << " at a table of " << options.numberOfSeats << (options.numberOfSeats == 1 ? " seat and " : " seats and ") <<
+        config.numberOfDecks << " decks with seed " << options.seed << " in " << duration.count() << " milliseconds\n";
+    cout << stats;
+    cout << evaluation::summarise(table::combineSeats(stats), 0.0);
+
+    return 0;
+}
+
+int runActionValueEstimation(const RunOptions &options){
+    policy::FrozenPolicy frozenPolicy;
+    evaluation::AgentFactory createAgent;
+
+    // The passive agent decides at random, so it has no frozen policy to play
+    if (options.evaluationTarget == "passive"){
+        std::cerr << "Only the greedy policy of a checkpoint has its action values estimated\n";
+        return 1;
+    }
+    if (!createAgentFactory(options.evaluationTarget, frozenPolicy, createAgent)){
+        return 1;
+    }
+
+    // Disable the per-round output of the environment and agents while the hands are played
+    cout.setstate(std::ios_base::failbit);
+
+    auto start = high_resolution_clock::now();
+    statistics::StateActionStatistics returnStatistics = statistics::estimateActionValues(
+        frozenPolicy, options.actionValueEpisodes, options.seed, options.evaluationConfig.numberOfThreads
+    );
+    auto duration = duration_cast<milliseconds>(high_resolution_clock::now() - start);
+
+    /* Re-enables output */
+    cout.clear();
+
+    cout << "Estimated the action values of " << options.evaluationTarget << " from " << options.actionValueEpisodes <<
+        " hands with seed " << options.seed << " in " << duration.count() << " milliseconds\n";
+    cout << returnStatistics;
+
+    return 0;
+}
+
+int runBankrollSimulation(const RunOptions &options){
+    policy::FrozenPolicy frozenPolicy;
+    evaluation::AgentFactory createAgent;
+
+    if (options.evaluationTarget == "passive"){
+        std::cerr << "Only the greedy policy of a checkpoint can be bet on\n";
+        return 1;
+    }
+    if (!createAgentFactory(options.evaluationTarget, frozenPolicy, createAgent)){
+        return 1;
+    }
+
+    table::TableConfig config = options.tableConfig;
+    config.seed = options.seed;
+
+    auto start = high_resolution_clock::now();
+    bankroll::OutcomeStream stream = bankroll::recordOutcomes(frozenPolicy, options.evaluationConfig.maxHands, config);
+    auto duration = duration_cast<milliseconds>(high_resolution_clock::now() - start);
+
+    cout << "Recorded " << stream.rewards.size() << " hands of " << options.evaluationTarget << " from a " << config.numberOfDecks <<
+        " deck shoe with seed " << options.seed << " in " << duration.count() << " milliseconds\n";
+    cout << bankroll::simulate(stream, options.bankrollConfig);
+
+    return 0;
+}
+
+int runComparison(const RunOptions &options){
+    policy::FrozenPolicy baselinePolicy, comparedPolicy;
+    std::vector<evaluation::AgentFactory> createAgents(2);
+
+    if (!createAgentFactory(options.evaluationTarget, baselinePolicy, createAgents[0]) ||
+        !createAgentFactory(options.comparisonTarget, comparedPolicy, createAgents[1])){
+        return 1;
+    }
+
+    environment::CardStream cardStream;
+    if (options.streamPath.empty() || !cardStream.loadFromFile(options.streamPath)){
+        cardStream = environment::CardStream::record(options.evaluationConfig.maxHands, options.seed);
+
+        if (!options.streamPath.empty() && !cardStream.saveToFile(options.streamPath)){
+            std::cerr << "The card stream could not be saved to " << options.streamPath << "\n";
+        }
+    }
+
+    // Disable the per-round output of the environment and agents while the hands are played
+    cout.setstate(std::ios_base::failbit);
+
+    auto start = high_resolution_clock::now();
+
+    evaluation::ComparisonResult result = evaluation::compare(
+        createAgents, cardStream, options.evaluationConfig.numberOfThreads, options.seed, options.evaluationConfig.steppingMode
+    );
+
+    auto duration = duration_cast<milliseconds>(high_resolution_clock::now() - start);
+
+    /* Re-enables output */
+    cout.clear();
+
+    cout << "Compared " << options.comparisonTarget << " (Agent 1) against " << options.evaluationTarget <<
+        " (Agent 0) on " << cardStream.getNumberOfHands() << " recorded hands in " << duration.count() << " milliseconds\n";
+    cout << result;
+
+    return 0;
+}
+
+void updateQValues( 
+    function::StateActionFunction &Q,
+    const statistics::StateActionStatistics &returnStatistics
+){
+    // Each record already holds the mean of its returns, so no division is left to do
+    returnStatistics.copyMeansTo(Q);
 
     for (int l = 0; l < 2; ++l){
         cout << (l ? "":"NO") << "Usable Ace\n";
         for (int i = 12; i <= environment::MAX_PLAYER_TOTAL; ++i){
             for (int j = 2; j <= environment::MAX_DEALER_SHOWING; ++j){
                 for (int k = 0; k < environment::MAX_POSSIBLE_ACTIONS; ++k){
-                        visitCountPtr = N.getImage(i, j, k, l), 
-                        returnSumPtr = returnSums.getImage(i, j, k, l),
-                        QValuePtr = Q.getImage(i, j, k, l);
-
-                        // If the pointers are valid and the count is none zero
-                        // Then we set the QValue to be the average returnSum over all visits
-                        if (pointersAreValid() && (*visitCountPtr) > 0){
-                            *QValuePtr = (*returnSumPtr) / (*visitCountPtr);
-                            cout << (k ? "h":"s")<< " -> (S = {p: " << i << ", d: " << j << "}; Q = " << *QValuePtr << "; A = " << l << ") ";
-                        }
+                    const statistics::RunningStatistics &returns = returnStatistics.getCell(i, j, k, l);
 
+                    if (returns.count > 0){
+                        cout << (k ? "h":"s")<< " -> (S = {p: " << i << ", d: " << j << "}; Q = " << returns.mean <<
+                            " +/- " << returns.halfWidth() << "; A = " << l << ") ";
+                    }
                 }
             }
             cout << "\n";
@@ -195,28 +880,6 @@ void updateQValues(
     }
 }
 
-float generateRewardValue(environment::GameResult outcome){
-    if (outcome == environment::GameResult::PLAYER_WIN){ // Win
-        return 1.0f;
-    } else if (outcome == environment::GameResult::DEALER_WIN){ // Loss
-        return -1.0f;
-    } else { // Draw
-        return 0.0f;
-    }
-}
-
-bool stateAndActionShouldBeRecorded(environment::GameState state){
-    cout << "Now checking whether to record the current state and action\n";
-    cout << "The dealers face down cards are " << (state.dealerCardsShown() ? "":"not") << " shown.\n";
-    cout << "The player total is " << 
-        (state.getPlayerTotal() >= 12   ? "greater than or equal to 12":"less than 12") << ".\n";
-
-    return (
-        !state.dealerCardsShown() && 
-        state.getPlayerTotal() >= 12    
-    );
-}
-
 /*  Takes a passive agent with a fixed policy and 
     stores the Q-Values related with its decisions.
     */
@@ -224,14 +887,15 @@ void monteCarloPredict(
     int numberOfSimulations, 
     agents::PassiveAgent &agent, 
     std::vector<StateAndAction> &visitedStatesAndActions, 
-    function::StateActionFunction &N, 
-    function::StateActionFunction &returnSums
+    statistics::StateActionStatistics &returnStatistics,
+    std::uint64_t seed // Episode i is dealt from substream i of the seed
 ){
     auto start = high_resolution_clock::now();
     
     cout << "Now evaluating the results of a fixed policy with a passive agent.\n";
     for (int i = 1; i <= numberOfSimulations; ++i){
         cout << "SIMULATION #" << i << ":\n";
+        environment::seedEpisode(seed, (std::uint64_t)i);
         environment::EnvironmentHandler testEnvironment;
         environment::GameState state = testEnvironment.getCurrentState();
 
@@ -239,9 +903,9 @@ void monteCarloPredict(
 
         /* Shift this to environment .hpp and .cpp then use the members of the class 
         to perform these actions internally */
-        runEpisode(agent, state, testEnvironment, visitedStatesAndActions, N);
+        runEpisode(agent, state, testEnvironment, visitedStatesAndActions);
 
-        updateReturnSums(state, visitedStatesAndActions, returnSums);
+        updateReturnStatistics(state, visitedStatesAndActions, returnStatistics);
 
         // Output the final game outcome
         cout << "Ultimate outcome: " << state.getOutcome() << "\n";
@@ -271,110 +935,69 @@ void monteCarloPredict(
 
 void monteCarloControl(
     int numberOfSimulations, 
-    agents::GreedyAgent &agent, 
-    function::StateActionFunction &Q, // Stores the utility for each of the state-action pairs 
-    std::vector<StateAndAction> &visitedStatesAndActions
+    trainer::Trainer &trainer,
+    writer::AsyncWriter &progressLog,
+    snapshot::SnapshotPublisher &publisher,
+    livestats::LiveStatsPublisher *liveStats
 ) {
     auto start = high_resolution_clock::now();
+    int episodesCompleted = 0;
+
+    livestats::LiveStats stats;
+    stats.numberOfEpisodes = (std::uint64_t)numberOfSimulations;
+    auto lastPublished = start;
+
+    // Only reads counters the trainer keeps anyway, and the clock and profiler once per publication
+    auto publishLiveStats = [&](){
+        auto now = high_resolution_clock::now();
+        double sincePublished = duration<double>(now - lastPublished).count();
+        const trainer::TrainerStats &trainerStats = trainer.getStats();
+
+        stats.episodesPerSecond = sincePublished > 0.0
+            ? (double)((std::uint64_t)episodesCompleted - stats.episodesCompleted) / sincePublished
+            : 0.0;
+        stats.episodesCompleted = (std::uint64_t)episodesCompleted;
+        stats.elapsedSeconds = duration<double>(now - start).count();
+        stats.meanReward = trainerStats.cumulativeReward / (double)trainerStats.episodesCompleted;
+        stats.currentWinnings = trainerStats.currentWinnings;
+        stats.highestWinnings = trainerStats.highestWinnings;
+        stats.epsilon = trainer.getAgent().getEpsilon();
+        stats.running = episodesCompleted < numberOfSimulations;
+        profiler::totals(stats.phaseNanoseconds, stats.phaseCalls);
+
+        liveStats->publish(stats);
+        lastPublished = now;
+    };
 
-    for (int i = 1; i <= numberOfSimulations; ++i){
-        cout << "SIMULATION #" << i << ":\n";
-        environment::EnvironmentHandler testEnvironment;
-        environment::GameState state = testEnvironment.getCurrentState();
-
-        agent.reset();
-        cout << "Initial agent action = " << agent.getAction() << "\n";
-
-        environment::Action agentDecision = agent.getAction();
-
-        /* Policy control starts here */
-        /* For actual */
-        while (state.getOutcome() == environment::GameResult::UNFINISHED){
-            // Check if the state is valid before allowing the agent to make a decision modifying itself in the process
-            // E.g. neither references returned from the function object should be null-pointers
-            if (Q(state, HIT) != nullptr && Q(state, STAND) != nullptr){
-                // Tell the agent what the optimal values are for hitting and standing given all prior states
-                agent.setActionValues(*Q(state, HIT), *Q(state, STAND));
-
-                // Consider the state and determine a decision to make
-                agentDecision = agent.considerState(state);
-
-                if (agentDecision == HIT) {
-                    cout << "The agent chooses to hit.\n";
-                } else {
-                    cout << "The agent chooses to stand.\n";
-                }
+    // Interleaved episodes finish out of order, so the reports count finished episodes rather than use their indices
+    trainer.train(numberOfSimulations, [&](const trainer::Trainer &finished){
+        ++episodesCompleted;
 
-                /* If first visit */
-                if ( stateAndActionShouldBeRecorded(
-                        state
-                     )
-                ){
-                    visitedStatesAndActions.emplace_back(state, agentDecision);
-                }
-            } 
-            // else {
-            //      // The only time it would be a nullptr is if the agent chose to stand previously
-            //     agentDecision = STAND;
-            // }
-
-            testEnvironment.simulateNextRound(agentDecision);
-            state = testEnvironment.getCurrentState();
+        if (episodesCompleted % snapshot::DEFAULT_SNAPSHOT_INTERVAL == 0 || episodesCompleted == numberOfSimulations){
+            publisher.publish(finished.getQ(), episodesCompleted);
         }
 
-        // Generate the reward value from the result of the game
-        float reward = generateRewardValue( state.getOutcome() );
-
-        /* Bet 5 as long as there player has 5 to bet */
-        if (currentWinnings >= 5){
-            currentWinnings += (int)reward * 5;
-            
-            highestWinnings = std::max(highestWinnings, currentWinnings);
+        if (liveStats != nullptr &&
+            (episodesCompleted % livestats::DEFAULT_PUBLISH_INTERVAL == 0 || episodesCompleted == numberOfSimulations)){
+            publishLiveStats();
         }
 
-        cumulativeReward += reward;
-
-        updateQValues(Q, visitedStatesAndActions, reward, 0.001f);
-
         cout << "Now sleeping for 5 seconds \n";
         // std::this_thread::sleep_for(milliseconds(5000));
-        if (numberOfSimulations > 100 && (i % (numberOfSimulations / 100) == 0)) {
+        if (numberOfSimulations > 100 && (episodesCompleted % (numberOfSimulations / 100) == 0)) {
             auto timeLog = high_resolution_clock::now();
             auto duration = duration_cast<milliseconds>(timeLog - start);
 
-            std::clog << i << " simulations completed in " << duration.count() << "milliseconds\n\n";
+            progressLog.tryWrite(std::to_string(episodesCompleted) + " simulations completed in " + std::to_string(duration.count()) + "milliseconds\n\n");
         }
-    }
-}
-
-void updateQValues(
-    function::StateActionFunction &Q,
-    std::vector<StateAndAction> &visitedStatesAndActions,
-    float G,
-    float learningFactor
-){
-    for (StateAndAction &p: visitedStatesAndActions){
-        environment::GameState state = p.first;
-        environment::Action action = p.second;
-        cout << "Now updating the Q-Values for:\n" << state << "\n with action " << action << "\n using reward " << G << "\n";
-
-        cout << "Q-Value before = " << *Q(state, action) << "\n";
-        /* Calculate the updates to the Q-Value using the learning factor to prevent rapid and drastic changes */
-        *Q(state, action) = *Q(state, action) + learningFactor * (G - *Q(state, action));
-
-        cout << "Q-Value after = " << *Q(state, action) << "\n";
-
-    }
-    // Clear the vector for future calculations
-    visitedStatesAndActions.clear();
+    });
 }
 
 void runEpisode(
     agents::PassiveAgent &agent, 
     environment::GameState &state, 
     environment::EnvironmentHandler &testEnvironment,    
-    std::vector<StateAndAction> &visitedStatesAndActions, 
-    function::StateActionFunction &N
+    std::vector<StateAndAction> &visitedStatesAndActions
 ) {
     while (state.getOutcome() == environment::GameResult::UNFINISHED) {
         // Consider the state and return the decision made
@@ -395,12 +1018,8 @@ void runEpisode(
         ){
 
             cout << "State not visited before" << "\n";
-            // cout << "(N) Count before incrementing = " << *N(state, agentDecision) << "\n";
-
-            ++(*N(state, agentDecision));
-
-            // cout << "(N) Count after incrementing = " << *N(state, agentDecision) << "\n";
 
+            // Counted with the pair's return once the episode is over
             visitedStatesAndActions.emplace_back(state, agentDecision);
         } else {
             cout << "Redundant state or state visited before in this episode :\n";
@@ -412,32 +1031,22 @@ void runEpisode(
     }
 }
 
-void updateReturnSums(
+void updateReturnStatistics(
     environment::GameState &state, 
     std::vector<StateAndAction> &visitedStatesAndActions, 
-    function::StateActionFunction &returnSums 
+    statistics::StateActionStatistics &returnStatistics
 ) {
-    // G holds the reward of the current episode, 1 for win, 0 for draw, 1 for loss based on the game outcome
-    float G = generateRewardValue(state.getOutcome());
-
-    // Iterate through the visitedStatesAndActions to update the returnSums now the reward is calculated
-    while (!visitedStatesAndActions.empty()) {
-        StateAndAction current = visitedStatesAndActions.back();
-
-        cout << "Return Sum before update = " << *returnSums(current.first, current.second) << "\n";
-
-        // Updates the return sum with the value of the current reward
-        *(returnSums(current.first, current.second)) += G;
-
-        cout << "Return Sum after update = " << *returnSums(current.first, current.second) << "\n";
+    PROFILE_SCOPE(profiler::Phase::Q_UPDATE);
 
+    // G holds the reward of the current episode, 1 for win, 0 for draw, 1 for loss based on the game outcome
+    float G = environment::generateRewardValue(state.getOutcome());
 
-        visitedStatesAndActions.pop_back();
-    }
+    // Counts the return towards every visited pair's mean and spread in one pass, leaving the visited pairs empty
+    returnStatistics.addReturn(visitedStatesAndActions, G);
 }
 
 void outputValueFunction(
-    function::StateActionFunction &Q
+    const function::StateActionFunction &Q
 ){
     /*  Outputs the value function by combining the q-values for each action in a given state
         into a sum for the entire state, since the q-values are averages */
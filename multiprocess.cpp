@@ -0,0 +1,207 @@
+#include "multiprocess.hpp"
+
+#include <new>
+#include <cerrno>
+#include <csignal>
+#include <cstdio>
+#include <chrono>
+#include <thread>
+#include <vector>
+#include <algorithm>
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+
+namespace {
+    /* Copies the shared images into an ordinary table, e.g. to checkpoint it */
+    void copyValues(const multiprocess::SharedTable &table, function::StateActionFunction &Q){
+        float *images = Q.data();
+        for (int i = 0; i < multiprocess::NUMBER_OF_IMAGES; ++i){
+            images[i] = table.values[i].load(std::memory_order_relaxed);
+        }
+    }
+
+    /* Writes to a temporary file first, so a crash mid write never leaves a truncated checkpoint behind */
+    bool writeCheckpoint(const multiprocess::SharedTable &table, const std::string &path){
+        function::StateActionFunction Q;
+        copyValues(table, Q);
+
+        std::string temporaryPath = path + ".tmp";
+        return Q.saveToFile(temporaryPath) && std::rename(temporaryPath.c_str(), path.c_str()) == 0;
+    }
+
+    /*  The body of a worker process, which claims and plays episodes until there are none left,
+        or until it has played crashAfter episodes if that is above 0 */
+    void runWorker(multiprocess::SharedTable &table, const multiprocess::MultiProcessConfig &config, long long crashAfter){
+        environment::EnvironmentHandler testEnvironment;
+        testEnvironment.setSteppingMode(config.steppingMode);
+        agents::GreedyAgent agent;
+        function::StateActionFunction Q;
+        std::vector<training::StateAndAction> visitedStatesAndActions;
+        visitedStatesAndActions.reserve(training::MAX_RECORDED_STATES);
+
+        copyValues(table, Q);
+        float *images = Q.data();
+
+        for (long long played = 1; ; ++played){
+            long long episode = table.nextEpisode.fetch_add(1);
+            if (episode >= config.numberOfEpisodes){
+                break;
+            }
+
+            testEnvironment.reset(config.seed, (std::uint64_t)episode);
+            float G = training::playEpisode(testEnvironment, agent, Q, visitedStatesAndActions);
+
+            // Other workers may be updating the same images, so each update is retried until it lands on the latest value
+            for (training::StateAndAction &p: visitedStatesAndActions){
+                int index = (int)(Q(p.first, p.second) - images);
+
+                std::uint32_t visits = table.visits[index].fetch_add(1, std::memory_order_relaxed) + 1;
+                float learningFactor = training::AdaptiveStepSize::stepSize(config.stepSizeConfig, visits);
+
+                float value = table.values[index].load(std::memory_order_relaxed), updated;
+                do {
+                    updated = value + learningFactor * (G - value);
+                } while (!table.values[index].compare_exchange_weak(value, updated, std::memory_order_relaxed));
+
+                images[index] = updated;
+            }
+            visitedStatesAndActions.clear();
+
+            table.rewardSum.fetch_add((long long)G, std::memory_order_relaxed);
+            table.episodesCompleted.fetch_add(1, std::memory_order_relaxed);
+
+            // Pick up the other workers' updates every so often
+            if (played % std::max(1, config.syncInterval) == 0){
+                copyValues(table, Q);
+            }
+
+            if (played == crashAfter){
+                raise(SIGKILL);
+            }
+        }
+    }
+
+    /* Returns the new worker's pid, or -1 if it could not be forked */
+    pid_t startWorker(multiprocess::SharedTable &table, const multiprocess::MultiProcessConfig &config, long long crashAfter = 0){
+        pid_t pid = fork();
+        if (pid == 0){
+            runWorker(table, config, crashAfter);
+
+            // Skip the parent's exit handlers and buffered output, which the worker only holds copies of
+            _exit(0);
+        }
+        return pid;
+    }
+}
+
+multiprocess::MultiProcessResult multiprocess::train(const MultiProcessConfig &config, function::StateActionFunction &Q){
+    MultiProcessResult result;
+
+    // The name only exists until the segment is mapped, so nothing is left behind if the run is killed
+    std::string name = "/blackjack_q_" + std::to_string((long long)getpid());
+    int descriptor = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+    if (descriptor < 0){
+        return result;
+    }
+
+    void *memory = MAP_FAILED;
+    if (ftruncate(descriptor, sizeof(SharedTable)) == 0){
+        memory = mmap(nullptr, sizeof(SharedTable), PROT_READ | PROT_WRITE, MAP_SHARED, descriptor, 0);
+    }
+    shm_unlink(name.c_str());
+    close(descriptor);
+
+    if (memory == MAP_FAILED){
+        return result;
+    }
+
+    // A new segment is zero filled, which is a valid zero table, but the atomics are still constructed properly
+    SharedTable &table = *new (memory) SharedTable();
+
+    // An atomic that needs a lock would keep that lock in the memory of a single process
+    if (!table.values[0].is_lock_free() || !table.nextEpisode.is_lock_free()){
+        table.~SharedTable();
+        munmap(memory, sizeof(SharedTable));
+        return result;
+    }
+
+    const float *initial = Q.data();
+    for (int i = 0; i < NUMBER_OF_IMAGES; ++i){
+        table.values[i].store(initial[i]);
+        table.visits[i].store(0);
+    }
+    table.nextEpisode.store(0);
+    table.episodesCompleted.store(0);
+    table.rewardSum.store(0);
+
+    int numberOfWorkers = config.numberOfWorkers > 0
+        ? config.numberOfWorkers
+        : std::max(1, (int)std::thread::hardware_concurrency());
+
+    std::vector<pid_t> workers;
+    result.succeeded = true;
+    for (int w = 0; w < numberOfWorkers; ++w){
+        pid_t pid = startWorker(table, config, w == 0 ? config.crashFirstWorkerAfter : 0);
+        if (pid < 0){
+            result.succeeded = false;
+            break;
+        }
+        workers.push_back(pid);
+    }
+
+    auto lastCheckpoint = std::chrono::steady_clock::now();
+
+    while (!workers.empty()){
+        // Only the workers are waited for, since the host's other children are none of the run's business
+        std::vector<pid_t> running;
+        int restarts = 0;
+
+        for (pid_t worker: workers){
+            int status = 0;
+            pid_t finished = waitpid(worker, &status, WNOHANG);
+            if (finished == 0 || (finished < 0 && errno == EINTR)){
+                running.push_back(worker);
+                continue;
+            }
+
+            /*  A worker that can no longer be waited for, e.g. because the host ignores SIGCHLD, is gone without a status.
+                Workers only exit normally once every episode is claimed, so taking it for a crash restarts nothing needlessly.
+                The episodes a crashed worker was playing are lost, but the rest of the run carries on. */
+            bool crashed = finished < 0 || !WIFEXITED(status) || WEXITSTATUS(status) != 0;
+            if (crashed && table.nextEpisode.load() < config.numberOfEpisodes && result.workersRestarted + restarts < MAX_WORKER_RESTARTS){
+                pid_t pid = startWorker(table, config);
+                if (pid > 0){
+                    running.push_back(pid);
+                    ++restarts;
+                }
+            }
+        }
+
+        workers.swap(running);
+        result.workersRestarted += restarts;
+
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+
+        if (!config.checkpointPath.empty() &&
+            std::chrono::steady_clock::now() - lastCheckpoint >= std::chrono::milliseconds(config.checkpointInterval)){
+            result.checkpointsWritten += writeCheckpoint(table, config.checkpointPath);
+            lastCheckpoint = std::chrono::steady_clock::now();
+        }
+    }
+
+    if (!config.checkpointPath.empty()){
+        result.checkpointsWritten += writeCheckpoint(table, config.checkpointPath);
+    }
+
+    copyValues(table, Q);
+    result.episodesCompleted = table.episodesCompleted.load();
+    result.rewardSum = (double)table.rewardSum.load();
+
+    table.~SharedTable();
+    munmap(memory, sizeof(SharedTable));
+
+    return result;
+}
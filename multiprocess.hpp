@@ -0,0 +1,82 @@
+#pragma once
+
+#ifndef MULTIPROCESS_H
+
+#define MULTIPROCESS_H
+
+#include <atomic>
+#include <string>
+#include <cstdint>
+#include "training.hpp"
+
+/*  Monte Carlo control split across forked worker processes that share one Q table, so a worker that crashes
+    only loses the episodes it was playing. Linux only, the table lives in a POSIX shared memory segment. */
+namespace multiprocess {
+
+    /* The number of images in a StateActionFunction, and so in the shared table */
+    const int NUMBER_OF_IMAGES =
+        function::FUNCTION_SHAPE[0] * function::FUNCTION_SHAPE[1] * function::FUNCTION_SHAPE[2] * function::FUNCTION_SHAPE[3];
+
+    /* A crashed worker is replaced at most this many times over a run, so a worker that always crashes cannot loop forever */
+    const int MAX_WORKER_RESTARTS = 16;
+
+    /*  The contents of the shared memory segment. Every field is a lock-free atomic, which stays correct
+        across processes since lock-free atomics do not depend on the address they are mapped at. */
+    struct SharedTable {
+        /* The images laid out exactly like StateActionFunction::data() */
+        std::atomic<float> values[NUMBER_OF_IMAGES];
+
+        /* The number of updates applied to each image, which drive the step sizes */
+        std::atomic<std::uint32_t> visits[NUMBER_OF_IMAGES];
+
+        /* The next episode to be claimed by a worker */
+        std::atomic<long long> nextEpisode;
+
+        std::atomic<long long> episodesCompleted;
+
+        /* Rewards are whole numbers, so their sum can be kept exactly */
+        std::atomic<long long> rewardSum;
+    };
+
+    struct MultiProcessConfig {
+        long long numberOfEpisodes = 100000;
+
+        /* 0 uses one worker per hardware thread */
+        int numberOfWorkers = 0;
+
+        /* Episode e is dealt from substream e of the seed, whichever worker plays it */
+        std::uint64_t seed = 0;
+
+        training::StepSizeConfig stepSizeConfig;
+
+        /* Every agent plays forced rounds without a random draw, so skipping them changes no result */
+        environment::SteppingMode steppingMode = environment::SteppingMode::DECISION_POINTS;
+
+        /* Written every checkpointInterval milliseconds and once more at the end, empty disables checkpoints */
+        std::string checkpointPath;
+        int checkpointInterval = 1000;
+
+        /* The episodes a worker plays between refreshing its private copy of Q, which it decides with */
+        int syncInterval = 1000;
+
+        /* Tests the restarts: the first worker started kills itself after playing this many episodes, 0 never */
+        long long crashFirstWorkerAfter = 0;
+    };
+
+    struct MultiProcessResult {
+        long long episodesCompleted = 0;
+        double rewardSum = 0.0;
+        int workersRestarted = 0;
+        int checkpointsWritten = 0;
+
+        /* False if the segment could not be created or a worker could not be started */
+        bool succeeded = false;
+    };
+
+    /*  Creates the shared table, forks the workers, replaces any that crash and checkpoints the table until every
+        episode has been played, then copies the final table into Q. The caller should not be running other threads,
+        since only the forking thread is copied into a worker. */
+    MultiProcessResult train(const MultiProcessConfig &config, function::StateActionFunction &Q);
+}
+
+#endif /* MULTIPROCESS_H */
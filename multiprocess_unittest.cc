@@ -0,0 +1,93 @@
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <vector>
+
+#include "multiprocess.hpp"
+#include "test_helpers.hpp"
+
+class MultiProcessTests : public testing::Test {
+    protected:
+        test_helpers::SilencedNarration silenced;
+};
+
+TEST_F(MultiProcessTests, WorkersPlayEveryEpisodeIntoTheSharedTable){
+    multiprocess::MultiProcessConfig config;
+    config.numberOfEpisodes = 20000;
+    config.numberOfWorkers = 3;
+    config.seed = 11;
+    config.syncInterval = 500;
+    config.checkpointPath = testing::TempDir() + "multiprocess_unittest.bjq";
+
+    function::StateActionFunction Q;
+    multiprocess::MultiProcessResult result = multiprocess::train(config, Q);
+
+    ASSERT_TRUE(result.succeeded);
+    EXPECT_EQ(20000, result.episodesCompleted);
+    EXPECT_EQ(0, result.workersRestarted);
+    EXPECT_GE(result.checkpointsWritten, 1);
+
+    // Rewards are between -1 and 1, so their sum is too
+    EXPECT_LE(result.rewardSum, 20000.0);
+    EXPECT_GE(result.rewardSum, -20000.0);
+
+    int updatedImages = 0;
+    for (int i = 0; i < multiprocess::NUMBER_OF_IMAGES; ++i){
+        updatedImages += Q.data()[i] != 0.0f;
+    }
+    EXPECT_GT(updatedImages, 0);
+
+    // The final checkpoint holds the same table that was copied back
+    function::StateActionFunction checkpoint;
+    bool loaded = checkpoint.loadFromFile(config.checkpointPath);
+    std::remove(config.checkpointPath.c_str());
+    std::remove((config.checkpointPath + ".tmp").c_str());
+
+    ASSERT_TRUE(loaded);
+    EXPECT_EQ(
+        std::vector<float>(Q.data(), Q.data() + multiprocess::NUMBER_OF_IMAGES),
+        std::vector<float>(checkpoint.data(), checkpoint.data() + multiprocess::NUMBER_OF_IMAGES)
+    );
+}
+
+TEST_F(MultiProcessTests, CrashedWorkerIsReplacedAndTheRunCarriesOn){
+    multiprocess::MultiProcessConfig config;
+    config.numberOfEpisodes = 20000;
+    config.numberOfWorkers = 2;
+    config.seed = 12;
+    config.stepSizeConfig.schedule = training::StepSizeSchedule::HARMONIC;
+    config.crashFirstWorkerAfter = 100;
+
+    function::StateActionFunction Q;
+    multiprocess::MultiProcessResult result = multiprocess::train(config, Q);
+
+    ASSERT_TRUE(result.succeeded);
+    EXPECT_EQ(1, result.workersRestarted);
+
+    // The worker dies between episodes, so none are lost
+    EXPECT_EQ(20000, result.episodesCompleted);
+
+    for (int i = 0; i < multiprocess::NUMBER_OF_IMAGES; ++i){
+        EXPECT_LE(Q.data()[i], 1.0f);
+        EXPECT_GE(Q.data()[i], -1.0f);
+    }
+}
+
+TEST_F(MultiProcessTests, HarmonicStepSizesKeepValuesWithinTheRewards){
+    multiprocess::MultiProcessConfig config;
+    config.numberOfEpisodes = 5000;
+    config.numberOfWorkers = 2;
+    config.stepSizeConfig.schedule = training::StepSizeSchedule::HARMONIC;
+
+    function::StateActionFunction Q;
+    multiprocess::MultiProcessResult result = multiprocess::train(config, Q);
+
+    ASSERT_TRUE(result.succeeded);
+    EXPECT_EQ(5000, result.episodesCompleted);
+
+    // Every image is an average of rewards, however the workers' updates interleaved
+    for (int i = 0; i < multiprocess::NUMBER_OF_IMAGES; ++i){
+        EXPECT_LE(Q.data()[i], 1.0f);
+        EXPECT_GE(Q.data()[i], -1.0f);
+    }
+}
@@ -0,0 +1,67 @@
+#!/usr/bin/env bash
+# Builds a profile-guided, link time optimised blackjack_ai trained on its own --workload,
+# then times it against a plain release build on the same workload.
+#
+# Usage: ./pgo_build.sh [build directory, build-pgo by default] [timed workload runs, 3 by default]
+#
+# The optimised binary is left in <build directory>/optimised/blackjack_ai. Both stages of the optimised build share
+# one build tree, since GCC names each profile after the path of the object file it was recorded for.
+set -euo pipefail
+
+source_dir="$(cd "$(dirname "$0")" && pwd)"
+build_dir="${1:-$source_dir/build-pgo}"
+runs="${2:-3}"
+profile_dir="$build_dir/profile"
+
+build() {
+    local tree="$1"
+    shift
+    cmake -S "$source_dir" -B "$build_dir/$tree" -DCMAKE_BUILD_TYPE=Release -DBLACKJACK_PGO_DIRECTORY="$profile_dir" "$@" > /dev/null
+    cmake --build "$build_dir/$tree" --target blackjack_ai -j"$(nproc)" > /dev/null
+}
+
+# Runs the timed workload and prints its output, which is echoed to stderr as it is kept
+run_workload() {
+    "$1" --workload "$runs" | tee /dev/stderr
+}
+
+# The fastest of the timed runs in milliseconds
+fastest_ms() {
+    echo "$1" | awk '/Fastest workload run/ { print $(NF - 1) }'
+}
+
+# The expected return of the trained policy, which both builds must reproduce exactly
+expected_return() {
+    echo "$1" | grep "Expected return"
+}
+
+echo "Building the plain release build"
+build plain -DBLACKJACK_PGO=OFF -DBLACKJACK_LTO=OFF
+
+echo "Building the instrumented build and recording its profile on the workload"
+rm -rf "$profile_dir"
+build optimised -DBLACKJACK_PGO=GENERATE -DBLACKJACK_LTO=OFF
+"$build_dir/optimised/blackjack_ai" --workload 1 > /dev/null
+
+echo "Rebuilding it with the profile and link time optimisation"
+build optimised -DBLACKJACK_PGO=USE -DBLACKJACK_LTO=ON
+
+echo "Timing the plain build"
+plain_output="$(run_workload "$build_dir/plain/blackjack_ai")"
+
+echo "Timing the optimised build"
+optimised_output="$(run_workload "$build_dir/optimised/blackjack_ai")"
+
+# The optimisations must not change what is computed, so a different result fails the build rather than being timed
+if [ "$(expected_return "$plain_output")" != "$(expected_return "$optimised_output")" ]; then
+    echo "The builds disagree: '$(expected_return "$plain_output")' against '$(expected_return "$optimised_output")'" >&2
+    exit 1
+fi
+
+plain_ms="$(fastest_ms "$plain_output")"
+optimised_ms="$(fastest_ms "$optimised_output")"
+
+awk -v plain="$plain_ms" -v optimised="$optimised_ms" 'BEGIN {
+    printf "Plain release build: %d ms, profile-guided and link time optimised build: %d ms, speed-up: %.2fx\n",
+        plain, optimised, plain / optimised
+}'
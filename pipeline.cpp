@@ -0,0 +1,242 @@
+#include "pipeline.hpp"
+#include "snapshot.hpp"
+
+#include <mutex>
+#include <chrono>
+#include <thread>
+#include <algorithm>
+
+namespace {
+    using Ring = pipeline::SpscRing<pipeline::EpisodeRecord>;
+
+    /* The counters of one thread, merged into the result once every thread has been joined */
+    struct ThreadStats {
+        long long episodes = 0, stalls = 0, pops = 0, depthSum = 0;
+        int maxDepth = 0;
+        double rewardSum = 0.0;
+    };
+
+    /* Shared by every thread of a run */
+    struct Stages {
+        const pipeline::PipelineConfig &config;
+        int numberOfProducers, numberOfLearners;
+
+        /* rings[p * numberOfLearners + l] carries producer p's records to learner l */
+        std::vector<std::unique_ptr<Ring>> rings;
+
+        std::atomic<long long> nextEpisode, episodesPlayed;
+        std::atomic<int> producersRunning;
+
+        /* The learners copy their own cells into the staged table and publish it, one at a time */
+        std::mutex stagingMutex;
+        function::StateActionFunction staged;
+        snapshot::SnapshotPublisher publisher;
+        long long publications;
+
+        Stages(const pipeline::PipelineConfig &config, int numberOfProducers, int numberOfLearners)
+            : config(config), numberOfProducers(numberOfProducers), numberOfLearners(numberOfLearners),
+            nextEpisode(0), episodesPlayed(0), producersRunning(numberOfProducers), publications(0) {}
+
+        Ring& ring(int producer, int learner){
+            return *rings[producer * numberOfLearners + learner];
+        }
+    };
+
+    void runProducer(Stages &stages, int producer, ThreadStats &stats){
+        environment::EnvironmentHandler testEnvironment;
+        testEnvironment.setSteppingMode(stages.config.steppingMode);
+        agents::GreedyAgent agent;
+        std::vector<training::StateAndAction> visitedStatesAndActions;
+        visitedStatesAndActions.reserve(training::MAX_RECORDED_STATES);
+
+        // The producer decides from its own copy of the latest published table, refreshed when a new one appears
+        function::StateActionFunction Q;
+        long long version = -1;
+
+        std::vector<pipeline::EpisodeRecord> records(stages.numberOfLearners);
+
+        for (;;){
+            long long episode = stages.nextEpisode.fetch_add(1, std::memory_order_relaxed);
+            if (episode >= stages.config.numberOfEpisodes){
+                break;
+            }
+
+            if (stages.publisher.getVersion() != version){
+                std::shared_ptr<const snapshot::Snapshot> latest = stages.publisher.acquire();
+                Q = latest->Q;
+                version = latest->version;
+            }
+
+            testEnvironment.reset(stages.config.seed, (std::uint64_t)episode);
+            float G = training::playEpisode(testEnvironment, agent, Q, visitedStatesAndActions);
+
+            // Each decision goes to the learner owning its cell
+            for (pipeline::EpisodeRecord &record: records){
+                record.reward = G;
+                record.numberOfDecisions = 0;
+            }
+            for (const training::StateAndAction &p: visitedStatesAndActions){
+                const environment::GameState &state = p.first;
+                pipeline::EpisodeRecord &record = records[state.getPlayerTotal() % stages.numberOfLearners];
+
+                record.decisions[record.numberOfDecisions++] = pipeline::RecordedDecision{
+                    (std::uint8_t)state.getPlayerTotal(), (std::uint8_t)state.getFaceupTotal(),
+                    (std::uint8_t)p.second, (std::uint8_t)state.doesPlayerHaveUsableAce()
+                };
+            }
+            visitedStatesAndActions.clear();
+
+            for (int l = 0; l < stages.numberOfLearners; ++l){
+                if (records[l].numberOfDecisions == 0){
+                    continue;
+                }
+
+                Ring &ring = stages.ring(producer, l);
+                while (!ring.tryPush(records[l])){
+                    ++stats.stalls;
+                    std::this_thread::yield();
+                }
+            }
+
+            ++stats.episodes;
+            stats.rewardSum += G;
+            stages.episodesPlayed.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        stages.producersRunning.fetch_sub(1, std::memory_order_release);
+    }
+
+    void runLearner(Stages &stages, int learner, function::StateActionFunction &Q, ThreadStats &stats){
+        // Only the counts of this learner's cells are ever used, the rest of its table stays at 0
+        training::AdaptiveStepSize stepSizes(stages.config.stepSizeConfig);
+
+        pipeline::EpisodeRecord record;
+        long long sincePublished = 0;
+
+        auto publish = [&](){
+            std::lock_guard<std::mutex> lock(stages.stagingMutex);
+
+            for (int i = learner; i <= environment::MAX_PLAYER_TOTAL; i += stages.numberOfLearners){
+                for (int j = 0; j <= environment::MAX_DEALER_SHOWING; ++j){
+                    for (int k = 0; k < environment::MAX_POSSIBLE_ACTIONS; ++k){
+                        for (int l = 0; l < 2; ++l){
+                            *stages.staged.getImage(i, j, k, l) = *Q.getImage(i, j, k, l);
+                        }
+                    }
+                }
+            }
+
+            stages.publisher.publish(stages.staged, stages.episodesPlayed.load(std::memory_order_relaxed));
+            ++stages.publications;
+            sincePublished = 0;
+        };
+
+        for (;;){
+            // Read before the rings are checked, so records pushed by a producer before it stopped are never missed
+            bool producersFinished = stages.producersRunning.load(std::memory_order_acquire) == 0;
+            bool popped = false;
+
+            for (int p = 0; p < stages.numberOfProducers; ++p){
+                Ring &ring = stages.ring(p, learner);
+
+                int depth = ring.size();
+                if (depth == 0 || !ring.tryPop(record)){
+                    continue;
+                }
+                popped = true;
+
+                ++stats.pops;
+                stats.depthSum += depth;
+                stats.maxDepth = std::max(stats.maxDepth, depth);
+
+                for (int d = 0; d < record.numberOfDecisions; ++d){
+                    const pipeline::RecordedDecision &decision = record.decisions[d];
+                    environment::Action action = environment::Action(decision.action);
+
+                    float *QValue = Q.getImage(decision.playerTotal, decision.faceupTotal, decision.action, decision.usableAce);
+                    float learningFactor = stepSizes.next(decision.playerTotal, decision.faceupTotal, action, decision.usableAce != 0);
+
+                    *QValue = *QValue + learningFactor * (record.reward - *QValue);
+                }
+
+                if (++sincePublished >= std::max(1, stages.config.publishInterval)){
+                    publish();
+                }
+            }
+
+            if (!popped){
+                if (producersFinished){
+                    break;
+                }
+
+                ++stats.stalls;
+                std::this_thread::yield();
+            }
+        }
+
+        publish();
+    }
+}
+
+pipeline::PipelineStats pipeline::train(const PipelineConfig &config, function::StateActionFunction &Q){
+    int numberOfLearners = std::max(1, std::min(config.numberOfLearners, environment::MAX_PLAYER_TOTAL + 1));
+    int numberOfProducers = config.numberOfProducers > 0
+        ? config.numberOfProducers
+        : std::max(1, (int)std::thread::hardware_concurrency() - numberOfLearners);
+
+    Stages stages(config, numberOfProducers, numberOfLearners);
+    for (int r = 0; r < numberOfProducers * numberOfLearners; ++r){
+        stages.rings.emplace_back(new Ring(config.ringCapacity));
+    }
+
+    // The producers start from the table they were given
+    stages.staged = Q;
+    stages.publisher.publish(stages.staged, 0);
+
+    std::vector<ThreadStats> producerStats(numberOfProducers), learnerStats(numberOfLearners);
+    std::vector<std::thread> threads;
+
+    auto start = std::chrono::steady_clock::now();
+
+    for (int l = 0; l < numberOfLearners; ++l){
+        threads.emplace_back(runLearner, std::ref(stages), l, std::ref(Q), std::ref(learnerStats[l]));
+    }
+    for (int p = 0; p < numberOfProducers; ++p){
+        threads.emplace_back(runProducer, std::ref(stages), p, std::ref(producerStats[p]));
+    }
+
+    for (std::thread &thread: threads){
+        thread.join();
+    }
+
+    PipelineStats result;
+    result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    for (const ThreadStats &stats: producerStats){
+        result.episodesProduced += stats.episodes;
+        result.producerStalls += stats.stalls;
+        result.rewardSum += stats.rewardSum;
+    }
+
+    long long depthSum = 0;
+    for (const ThreadStats &stats: learnerStats){
+        result.recordsLearned += stats.pops;
+        result.learnerStalls += stats.stalls;
+        result.maxQueueDepth = std::max(result.maxQueueDepth, stats.maxDepth);
+        depthSum += stats.depthSum;
+    }
+    result.meanQueueDepth = result.recordsLearned > 0 ? (double)depthSum / (double)result.recordsLearned : 0.0;
+    result.publications = stages.publications;
+
+    return result;
+}
+
+std::ostream& operator<<(std::ostream& o, const pipeline::PipelineStats &s){
+    o << s.episodesProduced << " episodes produced and " << s.recordsLearned << " records learned in " << s.seconds << " seconds (" <<
+        (s.seconds > 0.0 ? (double)s.episodesProduced / s.seconds : 0.0) << " episodes per second)\n" <<
+        "Mean reward = " << (s.episodesProduced > 0 ? s.rewardSum / (double)s.episodesProduced : 0.0) << "\n" <<
+        "Producer stalls on a full ring = " << s.producerStalls << ", learner stalls on empty rings = " << s.learnerStalls << "\n" <<
+        "Queue depth seen by the learners: mean " << s.meanQueueDepth << ", max " << s.maxQueueDepth << "\n" <<
+        "Snapshots published to the producers = " << s.publications << "\n";
+    return o;
+}
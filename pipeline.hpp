@@ -0,0 +1,157 @@
+#pragma once
+
+#ifndef PIPELINE_H
+
+#define PIPELINE_H
+
+#include <array>
+#include <atomic>
+#include <vector>
+#include <memory>
+#include <cstdint>
+#include "training.hpp"
+
+/*  Monte Carlo control split into simulation and learning stages on separate threads.
+    Producers play episodes and pass them on as compact records through lock-free rings,
+    learners apply the records to Q, so each stage can be given as many threads as it needs. */
+namespace pipeline {
+
+    /* Records each ring can hold, a power of two so a position maps to a slot with a mask */
+    const int DEFAULT_RING_CAPACITY = 1024;
+
+    /* Keeps the two ends of a ring on separate cache lines, so the producer and consumer do not invalidate each other */
+    const int CACHE_LINE_BYTES = 64;
+
+    /*  A bounded single producer, single consumer queue. Each end owns one index, which it alone writes,
+        and reads the other end's index only to tell whether the ring is full or empty,
+        so neither end ever waits on a lock or retries a compare-and-swap. */
+    template <typename T>
+    class SpscRing {
+    public:
+        /* The capacity is rounded up to a power of two */
+        SpscRing(int capacity = DEFAULT_RING_CAPACITY) : head(0), tail(0) {
+            int roundedCapacity = 1;
+            while (roundedCapacity < capacity){
+                roundedCapacity <<= 1;
+            }
+
+            slots.resize(roundedCapacity);
+            mask = (std::uint64_t)roundedCapacity - 1;
+        }
+
+        SpscRing(const SpscRing&) = delete;
+        SpscRing& operator=(const SpscRing&) = delete;
+
+        /* Called by the producer only, returns false without copying the item when the ring is full */
+        bool tryPush(const T &item){
+            std::uint64_t position = tail.load(std::memory_order_relaxed);
+            if (position - head.load(std::memory_order_acquire) > mask){
+                return false;
+            }
+
+            slots[position & mask] = item;
+            tail.store(position + 1, std::memory_order_release);
+            return true;
+        }
+
+        /* Called by the consumer only, returns false when the ring is empty */
+        bool tryPop(T &item){
+            std::uint64_t position = head.load(std::memory_order_relaxed);
+            if (position == tail.load(std::memory_order_acquire)){
+                return false;
+            }
+
+            item = slots[position & mask];
+            head.store(position + 1, std::memory_order_release);
+            return true;
+        }
+
+        /* The number of queued items, exact when called from either end and approximate from anywhere else */
+        int size() const{
+            return (int)(tail.load(std::memory_order_acquire) - head.load(std::memory_order_acquire));
+        }
+
+        int capacity() const{
+            return (int)mask + 1;
+        }
+
+    private:
+        std::vector<T> slots;
+        std::uint64_t mask;
+
+        // Padding rather than alignas, since a C++14 new does not honour alignments beyond the fundamental one
+        char headPadding[CACHE_LINE_BYTES];
+        std::atomic<std::uint64_t> head;
+        char tailPadding[CACHE_LINE_BYTES];
+        std::atomic<std::uint64_t> tail;
+    };
+
+    /* A recorded decision, indexed like StateActionFunction::getImage */
+    struct RecordedDecision {
+        std::uint8_t playerTotal, faceupTotal, action, usableAce;
+    };
+
+    /*  The part of a finished episode one learner needs: the reward and the recorded decisions in the cells it owns.
+        At most 72 bytes, where the StateAndAction pairs of the same episode would take kilobytes. */
+    struct EpisodeRecord {
+        float reward = 0.0f;
+        std::uint8_t numberOfDecisions = 0;
+        std::array<RecordedDecision, training::MAX_RECORDED_STATES> decisions;
+    };
+
+    struct PipelineConfig {
+        long long numberOfEpisodes = 100000;
+
+        /* 0 uses every hardware thread not taken by a learner */
+        int numberOfProducers = 0;
+
+        /* Each learner owns the cells of every player total t with t % numberOfLearners equal to its index */
+        int numberOfLearners = 1;
+
+        int ringCapacity = DEFAULT_RING_CAPACITY;
+
+        /* Episode e is dealt from substream e of the seed, whichever producer plays it */
+        std::uint64_t seed = 0;
+
+        training::StepSizeConfig stepSizeConfig;
+
+        /* Every agent plays forced rounds without a random draw, so skipping them changes no result */
+        environment::SteppingMode steppingMode = environment::SteppingMode::DECISION_POINTS;
+
+        /* The records a learner applies between publishing its cells, which is what the producers decide from */
+        int publishInterval = 1000;
+    };
+
+    /* Counters for tuning the ratio of producers to learners */
+    struct PipelineStats {
+        long long episodesProduced = 0, recordsLearned = 0;
+
+        /* Times a producer found a learner's ring full and had to wait, a sign of too few learners */
+        long long producerStalls = 0;
+
+        /* Times a learner found all of its rings empty and had to wait, a sign of too few producers */
+        long long learnerStalls = 0;
+
+        /* The depth of the ring a learner popped from, averaged over every pop, and the deepest seen */
+        double meanQueueDepth = 0.0;
+        int maxQueueDepth = 0;
+
+        double rewardSum = 0.0;
+
+        /* The number of times the producers' copy of Q was replaced */
+        long long publications = 0;
+
+        double seconds = 0.0;
+    };
+
+    /*  Runs the producers and learners until every episode has been played and learned from, then leaves the trained
+        table in Q. Producers decide from the latest table the learners have published, so as with the worker processes
+        the policy lags the updates by up to publishInterval records. Each producer has its own ring to each learner and
+        splits every episode between them, so every ring has exactly one producer and one consumer, and no two learners
+        ever write the same cell. */
+    PipelineStats train(const PipelineConfig &config, function::StateActionFunction &Q);
+}
+
+std::ostream& operator<<(std::ostream& o, const pipeline::PipelineStats &s);
+
+#endif /* PIPELINE_H */
@@ -0,0 +1,126 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <limits>
+#include <thread>
+#include <cstring>
+
+#include "pipeline.hpp"
+#include "test_helpers.hpp"
+
+class PipelineTests : public testing::Test {
+    protected:
+        test_helpers::SilencedNarration silenced;
+};
+
+TEST_F(PipelineTests, RingIsFirstInFirstOut){
+    pipeline::SpscRing<int> ring(5);
+    EXPECT_EQ(8, ring.capacity());
+
+    for (int i = 0; i < 8; ++i){
+        EXPECT_TRUE(ring.tryPush(i));
+    }
+    EXPECT_FALSE(ring.tryPush(8));
+    EXPECT_EQ(8, ring.size());
+
+    int item = -1;
+    for (int i = 0; i < 8; ++i){
+        ASSERT_TRUE(ring.tryPop(item));
+        EXPECT_EQ(i, item);
+
+        // Space freed at the front is reused at the back
+        EXPECT_TRUE(ring.tryPush(8 + i));
+    }
+    EXPECT_EQ(8, ring.size());
+}
+
+TEST_F(PipelineTests, RingPassesItemsBetweenThreadsInOrder){
+    const int numberOfItems = 100000;
+    pipeline::SpscRing<int> ring(1024);
+
+    // Lets the producer give up on a full ring once the consumer has stopped taking from it
+    std::atomic<bool> consumerStopped(false);
+
+    std::thread producer([&](){
+        for (int i = 0; i < numberOfItems; ++i){
+            while (!ring.tryPush(i)){
+                if (consumerStopped.load()){
+                    return;
+                }
+                std::this_thread::yield();
+            }
+        }
+    });
+
+    int expected = 0, item;
+    while (expected < numberOfItems){
+        if (!ring.tryPop(item)){
+            std::this_thread::yield();
+            continue;
+        }
+
+        EXPECT_EQ(expected, item);
+        if (item != expected){
+            break;
+        }
+        ++expected;
+    }
+    consumerStopped.store(true);
+    producer.join();
+
+    EXPECT_EQ(numberOfItems, expected);
+    EXPECT_FALSE(ring.tryPop(item));
+}
+
+TEST_F(PipelineTests, EveryEpisodeIsPlayedAndLearned){
+    pipeline::PipelineConfig config;
+    config.numberOfEpisodes = 20000;
+    config.numberOfProducers = 3;
+    config.numberOfLearners = 2;
+    config.ringCapacity = 16;
+    config.seed = 7;
+
+    function::StateActionFunction Q;
+    pipeline::PipelineStats stats = pipeline::train(config, Q);
+
+    EXPECT_EQ(20000, stats.episodesProduced);
+
+    // An episode sends one record to each learner owning one of its decisions, and some episodes have no decisions
+    EXPECT_GT(stats.recordsLearned, 0);
+    EXPECT_LE(stats.recordsLearned, 2 * stats.episodesProduced);
+
+    EXPECT_GT(stats.meanQueueDepth, 0.0);
+    EXPECT_LE(stats.maxQueueDepth, 16);
+    EXPECT_GE(stats.publications, 2);
+
+    int updatedImages = 0;
+    for (int i = 12; i <= environment::MAX_PLAYER_TOTAL; ++i){
+        updatedImages += *Q.getImage(i, 10, 0, 0) != 0.0f;
+    }
+    EXPECT_EQ(10, updatedImages);
+}
+
+TEST_F(PipelineTests, SplittingCellsBetweenLearnersGivesTheSameTable){
+    // One producer that never sees a new table plays the same episodes in the same order on every run
+    pipeline::PipelineConfig config;
+    config.numberOfEpisodes = 20000;
+    config.numberOfProducers = 1;
+    config.seed = 7;
+    config.publishInterval = std::numeric_limits<int>::max();
+    config.stepSizeConfig.schedule = training::StepSizeSchedule::HARMONIC;
+
+    function::StateActionFunction oneLearner, threeLearners;
+
+    config.numberOfLearners = 1;
+    pipeline::train(config, oneLearner);
+
+    config.numberOfLearners = 3;
+    pipeline::train(config, threeLearners);
+
+    std::size_t tableBytes = sizeof(float);
+    for (int extent: function::FUNCTION_SHAPE){
+        tableBytes *= extent;
+    }
+
+    EXPECT_EQ(0, std::memcmp(oneLearner.data(), threeLearners.data(), tableBytes));
+}
@@ -0,0 +1,80 @@
+#include "policy.hpp"
+
+policy::FrozenPolicy::FrozenPolicy() {
+    bits.fill(0);
+
+    for (int l = 0; l < 2; ++l){
+        for (int j = 0; j <= environment::MAX_DEALER_SHOWING; ++j){
+            for (int i = 0; i < 12; ++i){
+                setAction(i, j, l == 1, environment::Action::HIT);
+            }
+        }
+    }
+}
+
+policy::FrozenPolicy policy::FrozenPolicy::fromFunction(const function::StateActionFunction &Q) {
+    FrozenPolicy exported;
+
+    for (int l = 0; l < 2; ++l){
+        for (int j = 0; j <= environment::MAX_DEALER_SHOWING; ++j){
+            for (int i = 12; i <= environment::MAX_PLAYER_TOTAL; ++i){
+                float hitValue = *Q.getImage(i, j, 1, l), standValue = *Q.getImage(i, j, 0, l);
+
+                exported.setAction(i, j, l == 1, environment::Action(hitValue > standValue));
+            }
+        }
+    }
+
+    return exported;
+}
+
+environment::Action policy::FrozenPolicy::decide(const environment::GameState &state) const {
+    if (state.getPlayerTotal() > environment::MAX_PLAYER_TOTAL || state.getFaceupTotal() > environment::MAX_DEALER_SHOWING){
+        return environment::Action::STAND;
+    }
+
+    return decide(state.getPlayerTotal(), state.getFaceupTotal(), state.doesPlayerHaveUsableAce());
+}
+
+int policy::FrozenPolicy::countHits() const {
+    int hits = 0;
+    for (std::uint64_t word: bits){
+        hits += __builtin_popcountll(word);
+    }
+    return hits;
+}
+
+bool policy::FrozenPolicy::operator==(const FrozenPolicy &comparedPolicy) const {
+    return bits == comparedPolicy.bits;
+}
+
+void policy::FrozenPolicy::setAction(int playerTotal, int dealerShowing, bool usableAce, environment::Action action) {
+    int index = getIndex(playerTotal, dealerShowing, usableAce);
+    std::uint64_t mask = (std::uint64_t)1 << (index & 63);
+
+    if (action == environment::Action::HIT){
+        bits[index >> 6] |= mask;
+    } else {
+        bits[index >> 6] &= ~mask;
+    }
+}
+
+/* Outputs the policy as a strategy chart, H for hit and S for stand */
+std::ostream& operator<<(std::ostream& o, const policy::FrozenPolicy &p) {
+    for (int l = 0; l < 2; ++l){
+        o << "When the player " << (l ? "had":"did not have") << " a usable ace:\n    ";
+        for (int j = 2; j <= environment::MAX_DEALER_SHOWING; ++j){
+            o << (j < 10 ? " " : "") << j << " ";
+        }
+        o << "\n";
+
+        for (int i = 12; i <= environment::MAX_PLAYER_TOTAL; ++i){
+            o << i << ": ";
+            for (int j = 2; j <= environment::MAX_DEALER_SHOWING; ++j){
+                o << " " << (p.decide(i, j, l == 1) == environment::Action::HIT ? "H" : "S") << " ";
+            }
+            o << "\n";
+        }
+    }
+    return o;
+}
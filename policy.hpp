@@ -0,0 +1,60 @@
+#pragma once
+
+#ifndef POLICY_H
+
+#define POLICY_H
+
+#include <array>
+#include <cstdint>
+#include "environment.hpp"
+#include "function.hpp"
+
+namespace policy {
+
+    /* One bit for every player total, dealer face up total and usable ace combination */
+    const int POLICY_TABLE_SIZE = 2 * (environment::MAX_DEALER_SHOWING + 1) * (environment::MAX_PLAYER_TOTAL + 1);
+
+    const int POLICY_TABLE_WORDS = (POLICY_TABLE_SIZE + 63) / 64;
+
+    /*  An immutable greedy policy exported from a trained StateActionFunction.
+        Each state is stored as a single bit (1 = hit, 0 = stand) so the whole table fits in
+        a handful of cache lines and a decision is one indexed load and a shift. */
+    class FrozenPolicy {
+    public:
+        /* A policy that hits below 12 and stands everywhere else */
+        FrozenPolicy();
+
+        /*  Exports the greedy action of every state in Q, hitting only when the hit value is strictly
+            greater, like GreedyAgent. Totals under 12 always hit since it is impossible to bust. */
+        static FrozenPolicy fromFunction(const function::StateActionFunction &Q);
+
+        /* Position of a state's bit in the table, the usable ace flag is the outermost dimension */
+        static inline int getIndex(int playerTotal, int dealerShowing, bool usableAce) {
+            return ((int)usableAce * (environment::MAX_DEALER_SHOWING + 1) + dealerShowing)
+                * (environment::MAX_PLAYER_TOTAL + 1) + playerTotal;
+        }
+
+        /* The totals must be within the bounds of the StateActionFunction, no checks are made */
+        inline environment::Action decide(int playerTotal, int dealerShowing, bool usableAce) const {
+            int index = getIndex(playerTotal, dealerShowing, usableAce);
+            return environment::Action((bits[index >> 6] >> (index & 63)) & 1u);
+        }
+
+        /* Decides for a full game state, standing once the player total is out of bounds */
+        environment::Action decide(const environment::GameState &state) const;
+
+        /* The number of states in which the policy hits */
+        int countHits() const;
+
+        bool operator==(const FrozenPolicy &comparedPolicy) const;
+
+    private:
+        std::array<std::uint64_t, POLICY_TABLE_WORDS> bits;
+
+        void setAction(int playerTotal, int dealerShowing, bool usableAce, environment::Action action);
+    };
+}
+
+std::ostream& operator<<(std::ostream& o, const policy::FrozenPolicy &p);
+
+#endif /* POLICY_H */
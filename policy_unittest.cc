@@ -0,0 +1,87 @@
+#include <gtest/gtest.h>
+
+#include "agents.hpp"
+#include "policy.hpp"
+
+class PolicyTests : public testing::Test {
+    protected:
+        PolicyTests(){}
+
+        function::StateActionFunction Q;
+        game_assets::Deck deck;
+};
+
+TEST_F(PolicyTests, TableHasOneBitPerState){
+    EXPECT_EQ(528, policy::POLICY_TABLE_SIZE);
+    EXPECT_EQ(9, policy::POLICY_TABLE_WORDS);
+}
+
+TEST_F(PolicyTests, DefaultPolicyOnlyHitsBelowTwelve){
+    policy::FrozenPolicy frozenPolicy;
+
+    EXPECT_EQ(environment::Action::HIT, frozenPolicy.decide(11, 10, false));
+    EXPECT_EQ(environment::Action::STAND, frozenPolicy.decide(12, 10, false));
+    EXPECT_EQ(2 * 12 * (environment::MAX_DEALER_SHOWING + 1), frozenPolicy.countHits());
+}
+
+TEST_F(PolicyTests, ExportsGreedyActions){
+    // Hitting is better on hard 16 against a 10, standing is better on soft 18 against a 6
+    *Q.getImage(16, 10, 1, 0) = -0.5f;
+    *Q.getImage(16, 10, 0, 0) = -0.6f;
+    *Q.getImage(18, 6, 1, 1) = 0.1f;
+    *Q.getImage(18, 6, 0, 1) = 0.3f;
+
+    policy::FrozenPolicy frozenPolicy = policy::FrozenPolicy::fromFunction(Q);
+
+    EXPECT_EQ(environment::Action::HIT, frozenPolicy.decide(16, 10, false));
+    EXPECT_EQ(environment::Action::STAND, frozenPolicy.decide(18, 6, true));
+
+    // Ties stand, as they do for the greedy agent
+    EXPECT_EQ(environment::Action::STAND, frozenPolicy.decide(16, 10, true));
+
+    // Only the one state with a better hit value hits above 11
+    EXPECT_EQ(policy::FrozenPolicy().countHits() + 1, frozenPolicy.countHits());
+}
+
+TEST_F(PolicyTests, DecidesFromGameState){
+    *Q.getImage(18, 6, 1, 1) = 1.0f;
+    policy::FrozenPolicy frozenPolicy = policy::FrozenPolicy::fromFunction(Q);
+
+    environment::GameState state;
+
+    // Gives the dealer the Six of Hearts
+    state.addCard( deck[5], false );
+
+    // Gives the player the Ace of Diamonds and the Seven of Diamonds
+    state.addCard( deck[13], true );
+    state.addCard( deck[19], true );
+
+    EXPECT_EQ(environment::Action::HIT, frozenPolicy.decide(state));
+
+    // A bust player total is out of the table's bounds and stands
+    state.addCard( deck[22], true );
+    state.addCard( deck[23], true );
+    EXPECT_EQ(environment::Action::STAND, frozenPolicy.decide(state));
+}
+
+TEST_F(PolicyTests, PolicyAgentKeepsStanding){
+    policy::FrozenPolicy frozenPolicy;
+    agents::PolicyAgent agent(frozenPolicy);
+
+    environment::GameState state;
+
+    // Player 10 + 10 = 20 against a dealer 6
+    state.addCard( deck[5], false );
+    state.addCard( deck[9], true );
+    state.addCard( deck[22], true );
+
+    EXPECT_EQ(environment::Action::STAND, agent.considerState(state));
+
+    // Even a hand that would hit is stood on once the agent has stood
+    environment::GameState lowState;
+    lowState.addCard( deck[1], true );
+    EXPECT_EQ(environment::Action::STAND, agent.considerState(lowState));
+
+    agent.reset();
+    EXPECT_EQ(environment::Action::HIT, agent.considerState(lowState));
+}
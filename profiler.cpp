@@ -0,0 +1,166 @@
+#include "profiler.hpp"
+
+#include <mutex>
+#include <vector>
+#include <iomanip>
+#include <algorithm>
+
+namespace {
+    /* Every live thread's counters along with the totals of threads that have already exited */
+    struct Registry {
+        std::mutex lock;
+        std::vector<profiler::PhaseCounters*> live;
+        std::uint64_t retiredTicks[profiler::NUMBER_OF_PHASES] = {};
+        std::uint64_t retiredCalls[profiler::NUMBER_OF_PHASES] = {};
+
+        /* A reference point for converting ticks into nanoseconds */
+        std::uint64_t startTicks;
+        std::chrono::steady_clock::time_point startTime;
+
+        Registry() : startTicks(profiler::readTicks()), startTime(std::chrono::steady_clock::now()) {}
+    };
+
+    Registry& registry() {
+        static Registry r;
+        return r;
+    }
+
+    /* The number of ticks that pass per nanosecond, measured over the lifetime of the run */
+    double ticksPerNanosecond() {
+#ifdef PROFILER_USES_TSC
+        Registry &r = registry();
+        double elapsedNanoseconds = (double)std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - r.startTime
+        ).count();
+        double elapsedTicks = (double)(profiler::readTicks() - r.startTicks);
+
+        return elapsedNanoseconds > 0.0 ? elapsedTicks / elapsedNanoseconds : 1.0;
+#else
+        return 1.0;
+#endif
+    }
+}
+
+profiler::PhaseCounters::PhaseCounters() {
+    for (int i = 0; i < NUMBER_OF_PHASES; ++i){
+        ticks[i].store(0, std::memory_order_relaxed);
+        calls[i].store(0, std::memory_order_relaxed);
+    }
+
+    Registry &r = registry();
+    std::lock_guard<std::mutex> guard(r.lock);
+    r.live.push_back(this);
+}
+
+profiler::PhaseCounters::~PhaseCounters() {
+    Registry &r = registry();
+    std::lock_guard<std::mutex> guard(r.lock);
+
+    for (int i = 0; i < NUMBER_OF_PHASES; ++i){
+        r.retiredTicks[i] += ticks[i].load(std::memory_order_relaxed);
+        r.retiredCalls[i] += calls[i].load(std::memory_order_relaxed);
+    }
+
+    r.live.erase(std::remove(r.live.begin(), r.live.end(), this), r.live.end());
+}
+
+profiler::PhaseCounters& profiler::threadCounters() {
+    // Make sure the registry outlives the thread local counters that fold into it
+    registry();
+
+    thread_local PhaseCounters counters;
+    return counters;
+}
+
+void profiler::totals(double nanoseconds[NUMBER_OF_PHASES], std::uint64_t calls[NUMBER_OF_PHASES]) {
+    std::uint64_t totalTicks[NUMBER_OF_PHASES];
+
+    {
+        Registry &r = registry();
+        std::lock_guard<std::mutex> guard(r.lock);
+
+        for (int i = 0; i < NUMBER_OF_PHASES; ++i){
+            totalTicks[i] = r.retiredTicks[i];
+            calls[i] = r.retiredCalls[i];
+
+            for (PhaseCounters *counters: r.live){
+                totalTicks[i] += counters->ticks[i].load(std::memory_order_relaxed);
+                calls[i] += counters->calls[i].load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    double nanosecondsPerTick = 1.0 / ticksPerNanosecond();
+    for (int i = 0; i < NUMBER_OF_PHASES; ++i){
+        nanoseconds[i] = totalTicks[i] * nanosecondsPerTick;
+    }
+}
+
+void profiler::report(std::ostream &o) {
+    double totalNanoseconds[NUMBER_OF_PHASES];
+    std::uint64_t totalCalls[NUMBER_OF_PHASES];
+    totals(totalNanoseconds, totalCalls);
+
+    double episodeNanoseconds = totalNanoseconds[static_cast<int>(Phase::EPISODE)];
+
+    o << "Phase timings (" <<
+#ifdef PROFILER_USES_TSC
+        "time stamp counter"
+#else
+        "steady clock"
+#endif
+        << "):\n";
+    o << std::left << std::setw(16) << "phase" << std::right <<
+        std::setw(16) << "total (ms)" << std::setw(16) << "calls" <<
+        std::setw(12) << "ns/call" << std::setw(12) << "% episode" << "\n";
+
+    for (int i = 0; i < NUMBER_OF_PHASES; ++i){
+        o << std::left << std::setw(16) << Phase(i) << std::right << std::fixed << std::setprecision(2) <<
+            std::setw(16) << totalNanoseconds[i] / 1e6 <<
+            std::setw(16) << totalCalls[i] <<
+            std::setw(12) << (totalCalls[i] ? totalNanoseconds[i] / totalCalls[i] : 0.0) <<
+            std::setw(12) << (episodeNanoseconds > 0.0 ? 100.0 * totalNanoseconds[i] / episodeNanoseconds : 0.0) << "\n";
+    }
+
+    o << std::defaultfloat;
+}
+
+void profiler::reset() {
+    Registry &r = registry();
+    std::lock_guard<std::mutex> guard(r.lock);
+
+    for (int i = 0; i < NUMBER_OF_PHASES; ++i){
+        r.retiredTicks[i] = r.retiredCalls[i] = 0;
+
+        for (PhaseCounters *counters: r.live){
+            counters->ticks[i].store(0, std::memory_order_relaxed);
+            counters->calls[i].store(0, std::memory_order_relaxed);
+        }
+    }
+}
+
+std::ostream& operator<<(std::ostream& o, profiler::Phase p) {
+    switch (p) {
+        case profiler::Phase::DEAL:
+            o << "deal";
+            break;
+        case profiler::Phase::STATE_UPDATE:
+            o << "state update";
+            break;
+        case profiler::Phase::AGENT_DECISION:
+            o << "agent decision";
+            break;
+        case profiler::Phase::RESULT_CHECK:
+            o << "result check";
+            break;
+        case profiler::Phase::Q_UPDATE:
+            o << "Q update";
+            break;
+        case profiler::Phase::EPISODE:
+            o << "episode";
+            break;
+        default:
+            o << "undefined";
+    }
+    return o;
+}
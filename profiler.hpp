@@ -0,0 +1,102 @@
+#pragma once
+
+#ifndef PROFILER_H
+
+#define PROFILER_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#include <x86intrin.h>
+#define PROFILER_USES_TSC 1
+#endif
+
+/*  Scoped timers for the phases of an episode.
+    Timers are only compiled in when BLACKJACK_PROFILE is defined (see the BLACKJACK_ENABLE_PROFILER
+    CMake option), otherwise PROFILE_SCOPE expands to nothing and the hot path is untouched. */
+namespace profiler {
+
+    /* The parts of an episode that are timed separately */
+    enum class Phase :int {
+        DEAL = 0,           // selectOutOfRemainingCards
+        STATE_UPDATE,       // addCard and updateTotal
+        AGENT_DECISION,     // considerState
+        RESULT_CHECK,       // checkGameResult
+        Q_UPDATE,           // updateQValues
+        EPISODE             // A whole episode, so the phases can be compared against the total
+    };
+
+    const int NUMBER_OF_PHASES = 6;
+
+    /*  Per-thread totals. Only the owning thread writes to them, the atomics just allow
+        the report to read them while other threads are still running. */
+    struct PhaseCounters {
+        std::atomic<std::uint64_t> ticks[NUMBER_OF_PHASES];
+        std::atomic<std::uint64_t> calls[NUMBER_OF_PHASES];
+
+        PhaseCounters();
+
+        /* Folds this thread's totals into the run-wide totals once the thread exits */
+        ~PhaseCounters();
+    };
+
+    /* Reads the time stamp counter where available and the steady clock in nanoseconds otherwise */
+    inline std::uint64_t readTicks() {
+#ifdef PROFILER_USES_TSC
+        return __rdtsc();
+#else
+        return (std::uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()
+        ).count();
+#endif
+    }
+
+    /* The calling thread's counters, registered for reporting the first time they are used */
+    PhaseCounters& threadCounters();
+
+    /* Times the enclosing scope and adds it to the calling thread's counters for a phase */
+    class ScopedTimer {
+    public:
+        explicit ScopedTimer(Phase phase) : phase(phase), start(readTicks()) {}
+
+        ~ScopedTimer() {
+            PhaseCounters &counters = threadCounters();
+            int i = static_cast<int>(phase);
+
+            // Single writer, so a relaxed load and store is enough and avoids a locked add
+            counters.ticks[i].store(counters.ticks[i].load(std::memory_order_relaxed) + (readTicks() - start), std::memory_order_relaxed);
+            counters.calls[i].store(counters.calls[i].load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        }
+
+        ScopedTimer(const ScopedTimer&) = delete;
+        ScopedTimer& operator=(const ScopedTimer&) = delete;
+    private:
+        Phase phase;
+        std::uint64_t start;
+    };
+
+    /* Sums every thread's time in nanoseconds and calls of each phase so far, e.g. to publish them while a run goes on */
+    void totals(double nanoseconds[NUMBER_OF_PHASES], std::uint64_t calls[NUMBER_OF_PHASES]);
+
+    /* Outputs the totals, call counts and ns/call of every phase summed over all threads */
+    void report(std::ostream &o);
+
+    /* Zeroes the counters of every thread, e.g. to discard a warm-up */
+    void reset();
+}
+
+std::ostream& operator<<(std::ostream& o, profiler::Phase p);
+
+#define PROFILER_CONCATENATE_INNER(a, b) a##b
+#define PROFILER_CONCATENATE(a, b) PROFILER_CONCATENATE_INNER(a, b)
+
+#ifdef BLACKJACK_PROFILE
+#define PROFILE_SCOPE(phase) profiler::ScopedTimer PROFILER_CONCATENATE(profilerScopedTimer, __LINE__)(phase)
+#else
+#define PROFILE_SCOPE(phase)
+#endif
+
+#endif /* PROFILER_H */
@@ -0,0 +1,144 @@
+#include <chrono>
+#include <string>
+#include <vector>
+#include <iostream>
+
+#include "training.hpp"
+#include "evaluation.hpp"
+#include "quantized_function.hpp"
+
+/*  Compares the quantized table with the float table:
+        memory footprint of the images,
+        update throughput on a fixed stream of random updates,
+        and agreement of the greedy policies after training both on the same episodes.
+    Usage: quantization_benchmark [episodes] [seed] */
+
+using namespace std::chrono;
+
+namespace {
+    /* A random decision state, action and reward, fixed before timing so both tables replay the same stream */
+    struct Update {
+        int i, j, k, l;
+        float G;
+    };
+
+    double millisecondsSince(high_resolution_clock::time_point start){
+        return duration<double, std::milli>(high_resolution_clock::now() - start).count();
+    }
+
+    /* The share of decision states (player 12 to 21, every dealer card and ace flag) on which two policies agree */
+    double policyAgreement(const policy::FrozenPolicy &first, const policy::FrozenPolicy &second){
+        int agreed = 0, states = 0;
+        for (int l = 0; l < 2; ++l){
+            for (int j = 2; j <= environment::MAX_DEALER_SHOWING; ++j){
+                for (int i = 12; i <= environment::MAX_PLAYER_TOTAL; ++i){
+                    agreed += first.decide(i, j, l == 1) == second.decide(i, j, l == 1);
+                    ++states;
+                }
+            }
+        }
+        return (double)agreed / (double)states;
+    }
+
+    double largestDifference(function::StateActionFunction &Q, const function::QuantizedStateActionFunction &quantized){
+        double difference = 0.0;
+        for (int i = 12; i <= environment::MAX_PLAYER_TOTAL; ++i){
+            for (int j = 2; j <= environment::MAX_DEALER_SHOWING; ++j){
+                for (int k = 0; k < environment::MAX_POSSIBLE_ACTIONS; ++k){
+                    for (int l = 0; l < 2; ++l){
+                        difference = std::max(difference, (double)std::abs(*Q.getImage(i, j, k, l) - quantized.getImage(i, j, k, l)));
+                    }
+                }
+            }
+        }
+        return difference;
+    }
+}
+
+int main(int argc, char* argv[]){
+    long long numberOfEpisodes = argc > 1 ? std::stoll(argv[1]) : 1000000;
+    std::uint64_t seed = argc > 2 ? std::stoull(argv[2]) : 1;
+
+    function::StateActionFunction Q;
+    function::QuantizedStateActionFunction stochastic(seed), nearest(seed, false);
+
+    std::cout << "Memory footprint:\n" <<
+        "    float table     = " << sizeof(function::StateActionMatrix<std::array<float, 2>>) << " bytes\n" <<
+        "    quantized table = " << stochastic.memoryUsage() << " bytes\n\n";
+
+    // Update throughput on the same random stream
+    const int NUMBER_OF_UPDATES = 10000000;
+    std::vector<Update> updates(NUMBER_OF_UPDATES);
+    environment::RandomEngine engine(seed, 1);
+    for (Update &u: updates){
+        u.i = 12 + (int)(engine() % 10);
+        u.j = 2 + (int)(engine() % 10);
+        u.k = (int)(engine() % 2);
+        u.l = (int)(engine() % 2);
+        u.G = (float)((int)(engine() % 3) - 1);
+    }
+
+    function::StateActionFunction throughputQ;
+    function::QuantizedStateActionFunction throughputQuantized(seed);
+
+    auto start = high_resolution_clock::now();
+    for (const Update &u: updates){
+        float *value = throughputQ.getImage(u.i, u.j, u.k, u.l);
+        *value += training::LEARNING_FACTOR * (u.G - *value);
+    }
+    double floatTime = millisecondsSince(start);
+
+    start = high_resolution_clock::now();
+    for (const Update &u: updates){
+        throughputQuantized.updateImage(u.i, u.j, u.k, u.l, u.G, training::LEARNING_FACTOR);
+    }
+    double quantizedTime = millisecondsSince(start);
+
+    std::cout << "Update throughput over " << NUMBER_OF_UPDATES << " updates:\n" <<
+        "    float table     = " << NUMBER_OF_UPDATES / floatTime / 1000.0 << " million updates/s\n" <<
+        "    quantized table = " << NUMBER_OF_UPDATES / quantizedTime / 1000.0 << " million updates/s\n" <<
+        "    (checksum " << *throughputQ.getImage(16, 10, 1, 0) + throughputQuantized.getImage(16, 10, 1, 0) << ")\n\n";
+
+    // Train all three tables on the same episodes, with the float table choosing the actions
+    std::cout.setstate(std::ios_base::failbit);
+
+    environment::EnvironmentHandler testEnvironment;
+    agents::GreedyAgent agent;
+    std::vector<training::StateAndAction> visitedStatesAndActions;
+    visitedStatesAndActions.reserve(training::MAX_RECORDED_STATES);
+
+    for (long long episode = 0; episode < numberOfEpisodes; ++episode){
+        testEnvironment.reset(seed, (std::uint64_t)episode);
+        float G = training::playEpisode(testEnvironment, agent, Q, visitedStatesAndActions);
+
+        for (const training::StateAndAction &p: visitedStatesAndActions){
+            stochastic.update(p.first, p.second, G, training::LEARNING_FACTOR);
+            nearest.update(p.first, p.second, G, training::LEARNING_FACTOR);
+        }
+        training::updateQValues(Q, visitedStatesAndActions, G, training::LEARNING_FACTOR);
+    }
+
+    policy::FrozenPolicy floatPolicy = policy::FrozenPolicy::fromFunction(Q);
+    policy::FrozenPolicy stochasticPolicy = policy::FrozenPolicy::fromFunction(stochastic.toFunction());
+    policy::FrozenPolicy nearestPolicy = policy::FrozenPolicy::fromFunction(nearest.toFunction());
+
+    evaluation::EvaluationConfig config;
+    config.maxHands = 2000000;
+    config.seed = seed;
+
+    double floatReturn = evaluation::evaluate(floatPolicy, config).expectedReturn;
+    double stochasticReturn = evaluation::evaluate(stochasticPolicy, config).expectedReturn;
+    double nearestReturn = evaluation::evaluate(nearestPolicy, config).expectedReturn;
+
+    std::cout.clear();
+
+    std::cout << "After " << numberOfEpisodes << " training episodes:\n" <<
+        "    stochastic rounding: policy agreement = " << 100.0 * policyAgreement(floatPolicy, stochasticPolicy) <<
+        "%, largest difference = " << largestDifference(Q, stochastic) << "\n" <<
+        "    nearest rounding:    policy agreement = " << 100.0 * policyAgreement(floatPolicy, nearestPolicy) <<
+        "%, largest difference = " << largestDifference(Q, nearest) << "\n" <<
+        "    expected return over " << config.maxHands << " hands: float = " << floatReturn <<
+        ", stochastic = " << stochasticReturn << ", nearest = " << nearestReturn << "\n";
+
+    return 0;
+}
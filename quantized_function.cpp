@@ -0,0 +1,119 @@
+#include "quantized_function.hpp"
+
+#include <cmath>
+#include <limits>
+#include <algorithm>
+
+function::QuantizedStateActionFunction::QuantizedStateActionFunction(std::uint64_t seed, bool stochasticRounding) :
+    roundingEngine(seed), stochasticRounding(stochasticRounding) {
+    this->initialiseImages();
+}
+
+float function::QuantizedStateActionFunction::operator()(const environment::GameState &state, environment::Action action) const {
+    return getImage(state.getPlayerTotal(), state.getFaceupTotal(), action == environment::Action::HIT, state.doesPlayerHaveUsableAce());
+}
+
+float function::QuantizedStateActionFunction::getImage(int i, int j, int k, int l) const {
+    const std::int16_t *image = findImage(i, j, k, l);
+    return image != nullptr ? dequantize(*image) : 0.0f;
+}
+
+void function::QuantizedStateActionFunction::setImage(int i, int j, int k, int l, float value) {
+    std::int16_t *image = findImage(i, j, k, l);
+    if (image != nullptr) {
+        *image = quantize(value, 0.5f);
+    }
+}
+
+void function::QuantizedStateActionFunction::update(
+    const environment::GameState &state,
+    environment::Action action,
+    float G,
+    float learningFactor
+) {
+    updateImage(state.getPlayerTotal(), state.getFaceupTotal(), action == environment::Action::HIT, state.doesPlayerHaveUsableAce(), G, learningFactor);
+}
+
+void function::QuantizedStateActionFunction::updateImage(int i, int j, int k, int l, float G, float learningFactor) {
+    std::int16_t *image = findImage(i, j, k, l);
+    if (image == nullptr) {
+        return;
+    }
+
+    float value = dequantize(*image);
+    // The top 24 bits give a uniform offset in [0, 1) that a float holds exactly
+    float offset = stochasticRounding
+        ? (float)(roundingEngine() >> 8) * (1.0f / 16777216.0f)
+        : 0.5f;
+
+    *image = quantize(value + learningFactor * (G - value), offset);
+}
+
+void function::QuantizedStateActionFunction::initialiseImages() {
+    for (auto &row: mapping) {
+        for (auto &column: row) {
+            for (auto &slice: column) {
+                slice.fill(0);
+            }
+        }
+    }
+}
+
+function::QuantizedStateActionFunction function::QuantizedStateActionFunction::fromFunction(const StateActionFunction &Q) {
+    QuantizedStateActionFunction quantized;
+
+    for (int i = 0; i <= environment::MAX_PLAYER_TOTAL; ++i) {
+        for (int j = 0; j <= environment::MAX_DEALER_SHOWING; ++j) {
+            for (int k = 0; k < environment::MAX_POSSIBLE_ACTIONS; ++k) {
+                for (int l = 0; l < 2; ++l) {
+                    quantized.setImage(i, j, k, l, *Q.getImage(i, j, k, l));
+                }
+            }
+        }
+    }
+
+    return quantized;
+}
+
+function::StateActionFunction function::QuantizedStateActionFunction::toFunction() const {
+    StateActionFunction Q;
+
+    for (int i = 0; i <= environment::MAX_PLAYER_TOTAL; ++i) {
+        for (int j = 0; j <= environment::MAX_DEALER_SHOWING; ++j) {
+            for (int k = 0; k < environment::MAX_POSSIBLE_ACTIONS; ++k) {
+                for (int l = 0; l < 2; ++l) {
+                    *Q.getImage(i, j, k, l) = getImage(i, j, k, l);
+                }
+            }
+        }
+    }
+
+    return Q;
+}
+
+std::size_t function::QuantizedStateActionFunction::memoryUsage() const {
+    return sizeof(mapping);
+}
+
+std::int16_t function::QuantizedStateActionFunction::quantize(float value, float offset) {
+    // Values outside the representable range saturate instead of wrapping around
+    float scaled = std::floor(value * QUANTIZED_SCALE + offset);
+    scaled = std::max((float)std::numeric_limits<std::int16_t>::min(), std::min((float)std::numeric_limits<std::int16_t>::max(), scaled));
+    return (std::int16_t)scaled;
+}
+
+std::int16_t* function::QuantizedStateActionFunction::findImage(int i, int j, int k, int l) {
+    return const_cast<std::int16_t*>(static_cast<const QuantizedStateActionFunction*>(this)->findImage(i, j, k, l));
+}
+
+const std::int16_t* function::QuantizedStateActionFunction::findImage(int i, int j, int k, int l) const {
+    if (i < 0 || j < 0 || k < 0 ||
+        i > environment::MAX_PLAYER_TOTAL ||
+        j > environment::MAX_DEALER_SHOWING ||
+        k >= environment::MAX_POSSIBLE_ACTIONS ||
+        (l != 1 && l != 0)) {
+        return nullptr;
+    }
+
+    return &mapping[i][j][k][l];
+}
@@ -0,0 +1,77 @@
+#pragma once
+
+#ifndef QUANTIZED_FUNCTION_H
+
+#define QUANTIZED_FUNCTION_H
+
+#include <array>
+#include <cstdint>
+#include "function.hpp"
+
+namespace function {
+
+    /*  Quantized images are signed 16 bit fixed point numbers with 14 fraction bits,
+        so they cover [-2, 2) in steps of 1/16384, which holds any average of rewards in [-1, 1] */
+    const int QUANTIZED_FRACTION_BITS = 14;
+
+    const float QUANTIZED_SCALE = (float)(1 << QUANTIZED_FRACTION_BITS);
+
+    /*  The same mapping as StateActionFunction at half the size, for state spaces that would not fit in cache as floats.
+        Images are read and written as floats, but as 16 bit values they cannot be handed out by pointer,
+        so updates go through update rather than through a returned float*.
+
+        With a small learning factor most updates move a value by less than one quantization step,
+        and rounding to nearest would leave it stuck. Updates are therefore rounded stochastically, up with a
+        probability equal to the fraction of the step, so the expected value after an update is exact. */
+    class QuantizedStateActionFunction {
+        public:
+            /* The seed drives the stochastic rounding, separately from the episode generator so dealing is unaffected */
+            QuantizedStateActionFunction(std::uint64_t seed = 0, bool stochasticRounding = true);
+
+            /* Returns the value of a state and action, or 0 if the state is out of the table's bounds */
+            float operator()(const environment::GameState &state, environment::Action action) const;
+
+            /* Returns the image of a given function input, or 0 if the indices are out of bounds */
+            float getImage(int i, int j, int k, int l) const;
+
+            /* Stores the nearest representable value */
+            void setImage(int i, int j, int k, int l, float value);
+
+            /* Moves the value of a state and action towards G, states out of the table's bounds are ignored */
+            void update(const environment::GameState &state, environment::Action action, float G, float learningFactor);
+
+            void updateImage(int i, int j, int k, int l, float G, float learningFactor);
+
+            void initialiseImages();
+
+            /* Rounds every image of a float table to its nearest representable value */
+            static QuantizedStateActionFunction fromFunction(const StateActionFunction &Q);
+
+            /* Expands the images into a float table, e.g. to export a policy from them */
+            StateActionFunction toFunction() const;
+
+            /* Bytes held by the images */
+            std::size_t memoryUsage() const;
+
+            /* Converts value to fixed point, rounding down after adding offset, so 0.5 rounds to nearest */
+            static std::int16_t quantize(float value, float offset);
+
+            static inline float dequantize(std::int16_t value) {
+                return (float)value / QUANTIZED_SCALE;
+            }
+
+        private:
+            StateActionMatrix<std::array<std::int16_t, 2>> mapping;
+
+            environment::RandomEngine roundingEngine;
+
+            bool stochasticRounding;
+
+            /* Returns a nullptr if any index is out of bounds */
+            std::int16_t* findImage(int i, int j, int k, int l);
+
+            const std::int16_t* findImage(int i, int j, int k, int l) const;
+    };
+}
+
+#endif /* QUANTIZED_FUNCTION_H */
@@ -0,0 +1,55 @@
+#include <gtest/gtest.h>
+
+#include <cmath>
+
+#include "quantized_function.hpp"
+
+TEST(QuantizedFunctionTests, HalvesTheMemoryOfTheFloatTable){
+    function::QuantizedStateActionFunction quantized;
+    EXPECT_EQ(sizeof(function::StateActionMatrix<std::array<float, 2>>) / 2, quantized.memoryUsage());
+}
+
+TEST(QuantizedFunctionTests, RoundsToTheNearestStep){
+    function::QuantizedStateActionFunction quantized;
+    float step = 1.0f / function::QUANTIZED_SCALE;
+
+    quantized.setImage(16, 10, 1, 0, 0.3f);
+    EXPECT_NEAR(0.3f, quantized.getImage(16, 10, 1, 0), step / 2);
+
+    quantized.setImage(16, 10, 0, 0, -1.0f);
+    EXPECT_EQ(-1.0f, quantized.getImage(16, 10, 0, 0));
+
+    // Out of range values saturate and out of bounds indices are ignored
+    quantized.setImage(16, 10, 0, 1, 5.0f);
+    EXPECT_NEAR(2.0f, quantized.getImage(16, 10, 0, 1), step);
+
+    quantized.setImage(22, 10, 0, 0, 1.0f);
+    EXPECT_EQ(0.0f, quantized.getImage(22, 10, 0, 0));
+}
+
+TEST(QuantizedFunctionTests, StochasticRoundingTracksSmallUpdates){
+    function::QuantizedStateActionFunction stochastic(3), nearest(3, false);
+    function::StateActionFunction exact;
+
+    // Each update moves the value by less than half a step, which rounding to nearest always undoes
+    for (int n = 0; n < 20000; ++n){
+        stochastic.updateImage(12, 2, 1, 0, 1.0f, 0.00001f);
+        nearest.updateImage(12, 2, 1, 0, 1.0f, 0.00001f);
+        float *value = exact.getImage(12, 2, 1, 0);
+        *value += 0.00001f * (1.0f - *value);
+    }
+
+    EXPECT_EQ(0.0f, nearest.getImage(12, 2, 1, 0));
+    EXPECT_NEAR(*exact.getImage(12, 2, 1, 0), stochastic.getImage(12, 2, 1, 0), 0.01f);
+}
+
+TEST(QuantizedFunctionTests, ConvertsToAndFromFloatTables){
+    function::StateActionFunction Q;
+    *Q.getImage(18, 6, 0, 1) = 0.25f;
+    *Q.getImage(13, 2, 1, 0) = -0.4f;
+
+    function::StateActionFunction expanded = function::QuantizedStateActionFunction::fromFunction(Q).toFunction();
+
+    EXPECT_EQ(0.25f, *expanded.getImage(18, 6, 0, 1));
+    EXPECT_NEAR(-0.4f, *expanded.getImage(13, 2, 1, 0), 1.0f / function::QUANTIZED_SCALE);
+}
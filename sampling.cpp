@@ -0,0 +1,128 @@
+#include "sampling.hpp"
+
+#include <cmath>
+#include <algorithm>
+
+namespace {
+    double variance(const statistics::RunningStatistics &returns){
+        return returns.count > 1 ? returns.variance() : sampling::PRIOR_VARIANCE;
+    }
+}
+
+sampling::SumTree::SumTree(int numberOfLeaves) : numberOfLeaves(numberOfLeaves), firstLeaf(1) {
+    while (firstLeaf < numberOfLeaves){
+        firstLeaf <<= 1;
+    }
+    nodes.assign(2 * firstLeaf, 0.0);
+}
+
+void sampling::SumTree::update(int leaf, double weight){
+    int node = firstLeaf + leaf;
+    double change = weight - nodes[node];
+
+    for (; node >= 1; node >>= 1){
+        nodes[node] += change;
+    }
+}
+
+double sampling::SumTree::getWeight(int leaf) const{
+    return nodes[firstLeaf + leaf];
+}
+
+double sampling::SumTree::total() const{
+    return nodes[1];
+}
+
+int sampling::SumTree::find(double u) const{
+    int node = 1;
+    while (node < firstLeaf){
+        int left = 2 * node;
+        if (u < nodes[left]){
+            node = left;
+        } else {
+            u -= nodes[left];
+            node = left + 1;
+        }
+    }
+
+    // Rounding in the sums can carry a u just under the total past the last leaf with a weight
+    int leaf = node - firstLeaf;
+    while (leaf > 0 && (leaf >= numberOfLeaves || nodes[firstLeaf + leaf] <= 0.0)){
+        --leaf;
+    }
+    return leaf;
+}
+
+int sampling::SumTree::size() const{
+    return numberOfLeaves;
+}
+
+sampling::PrioritisedStartSampler::PrioritisedStartSampler()
+    : pairs(2 * training::NUMBER_OF_STARTING_STATES), priorities(2 * training::NUMBER_OF_STARTING_STATES) {
+    for (int pair = 0; pair < (int)pairs.size(); ++pair){
+        priorities.update(pair, priorityOf(pair));
+    }
+}
+
+training::ExploringStart sampling::PrioritisedStartSampler::draw(){
+    // The middle of one of 2^32 equal slices of [0, 1), so u never reaches the total
+    double u = ((double)environment::randomEngine()() + 0.5) / 4294967296.0;
+    return training::exploringStartFromIndex(priorities.find(u * priorities.total()));
+}
+
+void sampling::PrioritisedStartSampler::record(const training::ExploringStart &start, float G){
+    int pair = training::exploringStartIndex(start);
+    pairs[pair].add(G);
+
+    // The other action of the state is compared against this one, so its priority changes too
+    priorities.update(pair, priorityOf(pair));
+    priorities.update(pair ^ 1, priorityOf(pair ^ 1));
+}
+
+long long sampling::PrioritisedStartSampler::getVisits(const training::ExploringStart &start) const{
+    return (long long)pairs[training::exploringStartIndex(start)].count;
+}
+
+double sampling::PrioritisedStartSampler::getMeanReturn(const training::ExploringStart &start) const{
+    return pairs[training::exploringStartIndex(start)].mean;
+}
+
+double sampling::PrioritisedStartSampler::getVariance(const training::ExploringStart &start) const{
+    return variance(pairs[training::exploringStartIndex(start)]);
+}
+
+double sampling::PrioritisedStartSampler::getPriority(const training::ExploringStart &start) const{
+    return priorities.getWeight(training::exploringStartIndex(start));
+}
+
+double sampling::PrioritisedStartSampler::priorityOf(int pair) const{
+    const statistics::RunningStatistics &returns = pairs[pair], &alternative = pairs[pair ^ 1];
+
+    double standardError = std::sqrt(variance(returns) / (double)(returns.count + 1));
+    double alternativeError = std::sqrt(variance(alternative) / (double)(alternative.count + 1));
+
+    // How many standard errors apart the two actions are, the further the less likely more returns change the decision
+    double separation = std::fabs(returns.mean - alternative.mean) /
+        std::sqrt(standardError * standardError + alternativeError * alternativeError);
+
+    return std::max(MIN_PRIORITY, standardError / (1.0 + separation * separation));
+}
+
+float sampling::playPrioritisedEpisode(
+    environment::EnvironmentHandler &testEnvironment,
+    agents::GreedyAgent &agent,
+    function::StateActionFunction &Q,
+    std::vector<training::StateAndAction> &visitedStatesAndActions,
+    training::AdaptiveStepSize &stepSizes,
+    PrioritisedStartSampler &sampler,
+    std::uint64_t seed,
+    std::uint64_t episode
+){
+    environment::seedEpisode(seed, episode);
+
+    training::ExploringStart start = sampler.draw();
+    float G = training::playFromStart(testEnvironment, agent, Q, visitedStatesAndActions, stepSizes, start);
+
+    sampler.record(start, G);
+    return G;
+}
@@ -0,0 +1,98 @@
+#pragma once
+
+#ifndef SAMPLING_H
+
+#define SAMPLING_H
+
+#include <vector>
+#include <cstdint>
+#include "training.hpp"
+#include "statistics.hpp"
+
+/*  Chooses where training episodes start, spending them on the state-action pairs whose values are least certain
+    rather than spreading them evenly over pairs that have long since converged. */
+namespace sampling {
+
+    /* The largest variance a return in [-1, 1] can have, assumed for a pair until it has two returns of its own */
+    const double PRIOR_VARIANCE = 1.0;
+
+    /* Keeps every pair drawable, since a pair whose returns so far agree may still be wrong */
+    const double MIN_PRIORITY = 1e-3;
+
+    /*  Weights held in the leaves of a complete binary tree whose every inner node holds the sum of its children,
+        so changing a weight and drawing a leaf in proportion to its weight both take O(log n), however many leaves
+        there are. An alias table draws in O(1), but must be rebuilt in O(n) whenever a weight changes. */
+    class SumTree {
+    public:
+        /* Every weight starts at 0 */
+        SumTree(int numberOfLeaves);
+
+        void update(int leaf, double weight);
+
+        double getWeight(int leaf) const;
+
+        double total() const;
+
+        /* The leaf whose share of [0, total()) contains u, when the shares are laid out in order of leaf */
+        int find(double u) const;
+
+        int size() const;
+
+    private:
+        int numberOfLeaves;
+
+        /* The first leaf's index, a power of two, with node i's children at 2i and 2i + 1 and the root at 1 */
+        int firstLeaf;
+        std::vector<double> nodes;
+    };
+
+    /*  Tracks the returns of the episodes started from each exploring-start pair and draws the next start in proportion
+        to how uncertain the decision in its state still is. A pair's uncertainty is the standard error of its mean return,
+        sqrt(variance / (visits + 1)), shrunk by 1 + z^2, where z is the number of standard errors between the mean returns
+        of the state's two actions. Unvisited pairs therefore come first, and after that the episodes go to the states
+        whose best action is still in doubt rather than to those where hitting is plainly better or worse than standing.
+        Weighting by the standard error alone spends as many episodes on settled decisions as on close ones, since returns
+        are about as noisy in every state, and trains a worse policy than uniform starts. */
+    class PrioritisedStartSampler {
+    public:
+        PrioritisedStartSampler();
+
+        /* Draws a start with one number from the calling thread's generator */
+        training::ExploringStart draw();
+
+        /* Adds the return of an episode started from the pair and updates its priority and that of the state's other action */
+        void record(const training::ExploringStart &start, float G);
+
+        long long getVisits(const training::ExploringStart &start) const;
+
+        double getMeanReturn(const training::ExploringStart &start) const;
+
+        /* The sample variance of the pair's returns, PRIOR_VARIANCE until it has two */
+        double getVariance(const training::ExploringStart &start) const;
+
+        double getPriority(const training::ExploringStart &start) const;
+
+    private:
+        double priorityOf(int pair) const;
+
+        /* The running statistics of the returns of the episodes started from each pair */
+        std::vector<statistics::RunningStatistics> pairs;
+        SumTree priorities;
+    };
+
+    /*  As training::playExploringStartsEpisode, but starts from a pair drawn by the sampler, which then records the
+        episode's return. Episode e is still dealt from substream e of the seed, but the pair it starts from depends on
+        the returns of every episode before it. */
+    float playPrioritisedEpisode(
+        environment::EnvironmentHandler &testEnvironment,
+        agents::GreedyAgent &agent,
+        function::StateActionFunction &Q,
+        std::vector<training::StateAndAction> &visitedStatesAndActions,
+        training::AdaptiveStepSize &stepSizes,
+        PrioritisedStartSampler &sampler,
+        std::uint64_t seed,
+        std::uint64_t episode
+    );
+}
+
+#endif /* SAMPLING_H */
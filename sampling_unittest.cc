@@ -0,0 +1,161 @@
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <algorithm>
+
+#include "sampling.hpp"
+#include "test_helpers.hpp"
+
+class SamplingTests : public testing::Test {
+    protected:
+        test_helpers::SilencedNarration silenced;
+};
+
+TEST_F(SamplingTests, SumTreeFindsTheLeafOwningEachShare){
+    // Not a power of two, so the tree has empty leaves past the last
+    sampling::SumTree tree(5);
+    tree.update(0, 1.0);
+    tree.update(1, 0.0);
+    tree.update(2, 2.0);
+    tree.update(3, 0.5);
+    tree.update(4, 1.5);
+    EXPECT_DOUBLE_EQ(5.0, tree.total());
+
+    EXPECT_EQ(0, tree.find(0.0));
+    EXPECT_EQ(0, tree.find(0.99));
+    EXPECT_EQ(2, tree.find(1.0));
+    EXPECT_EQ(2, tree.find(2.99));
+    EXPECT_EQ(3, tree.find(3.2));
+    EXPECT_EQ(4, tree.find(3.5));
+    EXPECT_EQ(4, tree.find(4.99));
+
+    // Past the total lands on the last leaf with a weight rather than an empty one
+    EXPECT_EQ(4, tree.find(5.0));
+
+    tree.update(2, 0.25);
+    EXPECT_DOUBLE_EQ(3.25, tree.total());
+    EXPECT_DOUBLE_EQ(0.25, tree.getWeight(2));
+    EXPECT_EQ(3, tree.find(1.25));
+}
+
+TEST_F(SamplingTests, StartsAreNumberedOneToOne){
+    std::vector<bool> seen(2 * training::NUMBER_OF_STARTING_STATES, false);
+
+    for (int pair = 0; pair < 2 * training::NUMBER_OF_STARTING_STATES; ++pair){
+        training::ExploringStart start = training::exploringStartFromIndex(pair);
+
+        EXPECT_GE(start.playerTotal, training::LOWEST_DECISION_TOTAL);
+        EXPECT_LE(start.playerTotal, environment::MAX_PLAYER_TOTAL);
+        EXPECT_GE(start.faceupTotal, training::LOWEST_FACEUP_TOTAL);
+        EXPECT_LE(start.faceupTotal, environment::MAX_DEALER_SHOWING);
+
+        ASSERT_EQ(pair, training::exploringStartIndex(start));
+        seen[pair] = true;
+    }
+
+    EXPECT_EQ(seen.end(), std::find(seen.begin(), seen.end(), false));
+}
+
+TEST_F(SamplingTests, SamplerKeepsTheMeanAndVarianceOfEachStart){
+    sampling::PrioritisedStartSampler sampler;
+    training::ExploringStart start = training::exploringStartFromIndex(17);
+
+    EXPECT_EQ(0, sampler.getVisits(start));
+    EXPECT_DOUBLE_EQ(sampling::PRIOR_VARIANCE, sampler.getVariance(start));
+
+    const float returns[] = {1.0f, -1.0f, -1.0f, 0.0f, 1.0f, -1.0f};
+    for (float G: returns){
+        sampler.record(start, G);
+    }
+
+    // Mean -1/6, and squared deviations summing to 29/6 over 5 degrees of freedom
+    EXPECT_EQ(6, sampler.getVisits(start));
+    EXPECT_NEAR(-1.0 / 6.0, sampler.getMeanReturn(start), 1e-12);
+    EXPECT_NEAR(29.0 / 30.0, sampler.getVariance(start), 1e-12);
+
+    // The other action of the state has no returns, so its mean of 0 is one standard error away at most
+    double standardError = std::sqrt(29.0 / 30.0 / 7.0);
+    double separation = (1.0 / 6.0) / std::sqrt(standardError * standardError + sampling::PRIOR_VARIANCE);
+    EXPECT_NEAR(standardError / (1.0 + separation * separation), sampler.getPriority(start), 1e-12);
+}
+
+TEST_F(SamplingTests, SettledStartsAreDrawnLessThanNoisyOnes){
+    sampling::PrioritisedStartSampler sampler;
+    training::ExploringStart settled = training::exploringStartFromIndex(3), noisy = training::exploringStartFromIndex(4);
+
+    // The same number of visits, so only the spread of the returns separates the two
+    for (int i = 0; i < 200; ++i){
+        sampler.record(settled, 1.0f);
+        sampler.record(noisy, i % 2 == 0 ? 1.0f : -1.0f);
+    }
+    EXPECT_DOUBLE_EQ(sampling::MIN_PRIORITY, sampler.getPriority(settled));
+    EXPECT_GT(sampler.getPriority(noisy), 50 * sampling::MIN_PRIORITY);
+
+    environment::seedEpisode(11, 0);
+    int settledDraws = 0, noisyDraws = 0, unvisitedDraws = 0;
+    for (int i = 0; i < 100000; ++i){
+        training::ExploringStart start = sampler.draw();
+        int pair = training::exploringStartIndex(start);
+
+        settledDraws += pair == 3;
+        noisyDraws += pair == 4;
+        unvisitedDraws += sampler.getVisits(start) == 0;
+    }
+
+    EXPECT_GT(noisyDraws, 10 * settledDraws);
+
+    // The starts never visited have the largest priority of all
+    EXPECT_GT(unvisitedDraws, 99 * noisyDraws);
+}
+
+TEST_F(SamplingTests, DecidedStatesAreDrawnLessThanCloseOnes){
+    sampling::PrioritisedStartSampler sampler;
+
+    // Equally noisy returns, but hitting is far worse than standing in one state and as good in the other
+    training::ExploringStart decidedStand = training::exploringStartFromIndex(0), decidedHit = training::exploringStartFromIndex(1);
+    training::ExploringStart closeStand = training::exploringStartFromIndex(2), closeHit = training::exploringStartFromIndex(3);
+
+    for (int i = 0; i < 100; ++i){
+        float noise = i % 2 == 0 ? 0.5f : -0.5f;
+        sampler.record(decidedStand, 0.4f + noise);
+        sampler.record(decidedHit, -0.4f + noise);
+        sampler.record(closeStand, noise);
+        sampler.record(closeHit, -noise);
+    }
+
+    EXPECT_NEAR(sampler.getVariance(decidedHit), sampler.getVariance(closeHit), 1e-6);
+    EXPECT_GT(sampler.getPriority(closeStand), 10 * sampler.getPriority(decidedStand));
+    EXPECT_GT(sampler.getPriority(closeHit), 10 * sampler.getPriority(decidedHit));
+}
+
+TEST_F(SamplingTests, PrioritisedEpisodesVisitEveryPair){
+    environment::EnvironmentHandler testEnvironment;
+    testEnvironment.setSteppingMode(environment::SteppingMode::DECISION_POINTS);
+
+    agents::GreedyAgent agent;
+    function::StateActionFunction Q;
+    std::vector<training::StateAndAction> visitedStatesAndActions;
+    training::AdaptiveStepSize stepSizes;
+    sampling::PrioritisedStartSampler sampler;
+
+    for (int i = 0; i < 4000; ++i){
+        sampling::playPrioritisedEpisode(
+            testEnvironment, agent, Q, visitedStatesAndActions, stepSizes, sampler, 7, (std::uint64_t)i
+        );
+    }
+    EXPECT_TRUE(visitedStatesAndActions.empty());
+
+    long long recordedEpisodes = 0;
+    int pairsMissed = 0;
+    for (int pair = 0; pair < 2 * training::NUMBER_OF_STARTING_STATES; ++pair){
+        training::ExploringStart start = training::exploringStartFromIndex(pair);
+        recordedEpisodes += sampler.getVisits(start);
+
+        pairsMissed += stepSizes.getVisits(
+            start.playerTotal, start.faceupTotal, (int)start.firstAction, start.usableAce ? 1 : 0
+        ) == 0;
+    }
+
+    EXPECT_EQ(4000, recordedEpisodes);
+    EXPECT_EQ(0, pairsMissed);
+}
@@ -0,0 +1,38 @@
+#include "snapshot.hpp"
+
+snapshot::SnapshotPublisher::SnapshotPublisher() : current(std::make_shared<Snapshot>()), version(0), tablesAllocated(1) {}
+
+void snapshot::SnapshotPublisher::publish(const function::StateActionFunction &Q, long long episodes) {
+    // A spare table still held by a reader cannot be written to, so a new one is made instead
+    std::shared_ptr<Snapshot> next;
+    if (spare && spare.use_count() == 1) {
+        // Pairs with the release of the last reader's reference, so its reads finish before the table is overwritten
+        std::atomic_thread_fence(std::memory_order_acquire);
+        next = std::move(spare);
+    } else {
+        next = std::make_shared<Snapshot>();
+        ++tablesAllocated;
+    }
+
+    next->Q = Q;
+    next->episodes = episodes;
+    next->version = version.load(std::memory_order_relaxed) + 1;
+
+    // Readers acquiring from here on see the new table, the old one becomes the spare
+    std::shared_ptr<const Snapshot> previous = std::atomic_exchange(&current, std::shared_ptr<const Snapshot>(next));
+    version.store(next->version, std::memory_order_release);
+
+    spare = std::const_pointer_cast<Snapshot>(previous);
+}
+
+std::shared_ptr<const snapshot::Snapshot> snapshot::SnapshotPublisher::acquire() const {
+    return std::atomic_load(&current);
+}
+
+long long snapshot::SnapshotPublisher::getVersion() const {
+    return version.load(std::memory_order_acquire);
+}
+
+long long snapshot::SnapshotPublisher::getTablesAllocated() const {
+    return tablesAllocated;
+}
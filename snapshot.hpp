@@ -0,0 +1,62 @@
+#pragma once
+
+#ifndef SNAPSHOT_H
+
+#define SNAPSHOT_H
+
+#include <memory>
+#include <atomic>
+#include "function.hpp"
+
+namespace snapshot {
+
+    /* The episodes between two published snapshots of a training run */
+    const int DEFAULT_SNAPSHOT_INTERVAL = 10000;
+
+    /* An immutable copy of a Q table, which stays valid for as long as a reader holds it */
+    struct Snapshot {
+        function::StateActionFunction Q;
+
+        /* The number of episodes that had been trained when the copy was taken */
+        long long episodes = 0;
+
+        /* Counts the publications, so a reader can tell whether anything changed since its last look */
+        long long version = 0;
+    };
+
+    /*  Shares a training Q table with concurrent readers, RCU style.
+        The trainer copies its table into a snapshot and publishes it with an atomic pointer swap,
+        so the table it keeps updating in place is never seen by a reader and no reader sees a torn update.
+        Readers take a reference to the latest snapshot, and the only synchronisation on the training side is the
+        swap itself every few thousand episodes, never anything in the per-episode hot path.
+        The table replaced by a publication is reused for the next one once its last reader lets go,
+        so a run normally only ever holds two tables. */
+    class SnapshotPublisher {
+    public:
+        /* Starts with a zero table published as version 0 */
+        SnapshotPublisher();
+
+        /* Called from the training thread only */
+        void publish(const function::StateActionFunction &Q, long long episodes);
+
+        /* The latest published snapshot, safe to call from any thread */
+        std::shared_ptr<const Snapshot> acquire() const;
+
+        long long getVersion() const;
+
+        /* The number of publications that needed a new table because a reader still held the spare one */
+        long long getTablesAllocated() const;
+
+    private:
+        std::shared_ptr<const Snapshot> current;
+
+        /* The previously published snapshot, only touched by the training thread */
+        std::shared_ptr<Snapshot> spare;
+
+        std::atomic<long long> version;
+
+        long long tablesAllocated;
+    };
+}
+
+#endif /* SNAPSHOT_H */
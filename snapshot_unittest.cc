@@ -0,0 +1,104 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <thread>
+
+#include "snapshot.hpp"
+
+namespace {
+    /* Sets every image of a table to the same value, so a torn copy would hold a mix of values */
+    void fillTable(function::StateActionFunction &Q, float value){
+        for (int i = 0; i <= environment::MAX_PLAYER_TOTAL; ++i){
+            for (int j = 0; j <= environment::MAX_DEALER_SHOWING; ++j){
+                for (int k = 0; k < environment::MAX_POSSIBLE_ACTIONS; ++k){
+                    *Q.getImage(i, j, k, 0) = *Q.getImage(i, j, k, 1) = value;
+                }
+            }
+        }
+    }
+}
+
+TEST(SnapshotTests, StartsWithAZeroTable){
+    snapshot::SnapshotPublisher publisher;
+    std::shared_ptr<const snapshot::Snapshot> initial = publisher.acquire();
+
+    EXPECT_EQ(0, publisher.getVersion());
+    EXPECT_EQ(0, initial->episodes);
+    EXPECT_EQ(0.0f, *initial->Q.getImage(16, 10, 1, 0));
+}
+
+TEST(SnapshotTests, HeldSnapshotsDoNotChange){
+    snapshot::SnapshotPublisher publisher;
+    function::StateActionFunction Q;
+
+    fillTable(Q, 1.0f);
+    publisher.publish(Q, 100);
+    std::shared_ptr<const snapshot::Snapshot> first = publisher.acquire();
+
+    // Training carries on changing its own table, then publishes twice more
+    fillTable(Q, 2.0f);
+    publisher.publish(Q, 200);
+    publisher.publish(Q, 300);
+
+    EXPECT_EQ(1, first->version);
+    EXPECT_EQ(100, first->episodes);
+    EXPECT_EQ(1.0f, *first->Q.getImage(16, 10, 1, 0));
+
+    EXPECT_EQ(3, publisher.getVersion());
+    EXPECT_EQ(300, publisher.acquire()->episodes);
+    EXPECT_EQ(2.0f, *publisher.acquire()->Q.getImage(16, 10, 1, 0));
+}
+
+TEST(SnapshotTests, ReleasedTablesAreReused){
+    snapshot::SnapshotPublisher publisher;
+    function::StateActionFunction Q;
+
+    // Nobody holds the replaced tables, so two tables serve every publication
+    for (int i = 1; i <= 10; ++i){
+        publisher.publish(Q, i);
+    }
+    EXPECT_EQ(2, publisher.getTablesAllocated());
+
+    // A reader holding the spare table forces a new one
+    std::shared_ptr<const snapshot::Snapshot> held = publisher.acquire();
+    publisher.publish(Q, 11);
+    publisher.publish(Q, 12);
+    EXPECT_EQ(3, publisher.getTablesAllocated());
+}
+
+TEST(SnapshotTests, ConcurrentReadersNeverSeeTornTables){
+    snapshot::SnapshotPublisher publisher;
+    std::atomic<bool> finished(false);
+    std::atomic<long long> tornReads(0), reads(0);
+
+    std::vector<std::thread> readers;
+    for (int t = 0; t < 3; ++t){
+        readers.emplace_back([&](){
+            while (!finished){
+                std::shared_ptr<const snapshot::Snapshot> latest = publisher.acquire();
+                float first = *latest->Q.getImage(0, 0, 0, 0);
+
+                for (int i = 0; i <= environment::MAX_PLAYER_TOTAL; ++i){
+                    for (int j = 0; j <= environment::MAX_DEALER_SHOWING; ++j){
+                        tornReads += *latest->Q.getImage(i, j, 1, 1) != first;
+                    }
+                }
+                ++reads;
+            }
+        });
+    }
+
+    function::StateActionFunction Q;
+    for (int i = 1; i <= 2000; ++i){
+        fillTable(Q, (float)i);
+        publisher.publish(Q, i);
+    }
+
+    finished = true;
+    for (std::thread &reader: readers){
+        reader.join();
+    }
+
+    EXPECT_GT(reads.load(), 0);
+    EXPECT_EQ(0, tornReads.load());
+}
@@ -0,0 +1,153 @@
+#include "statistics.hpp"
+
+#include <cmath>
+#include <thread>
+#include <algorithm>
+
+void statistics::RunningStatistics::add(double value){
+    ++count;
+    double deviation = value - mean;
+    mean += deviation / (double)count;
+    m2 += deviation * (value - mean);
+}
+
+void statistics::RunningStatistics::merge(const RunningStatistics &other){
+    if (other.count == 0){
+        return;
+    }
+    if (count == 0){
+        *this = other;
+        return;
+    }
+
+    double n = (double)(count + other.count);
+    double difference = other.mean - mean;
+
+    mean += difference * (double)other.count / n;
+    m2 += other.m2 + difference * difference * (double)count * (double)other.count / n;
+    count += other.count;
+}
+
+double statistics::RunningStatistics::variance() const{
+    return count > 1 ? m2 / (double)(count - 1) : 0.0;
+}
+
+double statistics::RunningStatistics::standardError() const{
+    return count > 0 ? std::sqrt(variance() / (double)count) : 0.0;
+}
+
+double statistics::RunningStatistics::halfWidth(double z) const{
+    return z * standardError();
+}
+
+void statistics::StateActionStatistics::add(const environment::GameState &state, environment::Action action, double G){
+    // Recorded states are decisions, so their totals are always within the table
+    cells[state.getPlayerTotal()][state.getFaceupTotal()][action == environment::Action::HIT][state.doesPlayerHaveUsableAce()].add(G);
+}
+
+void statistics::StateActionStatistics::addReturn(std::vector<training::StateAndAction> &visitedStatesAndActions, double G){
+    for (const training::StateAndAction &visited: visitedStatesAndActions){
+        add(visited.first, visited.second, G);
+    }
+    visitedStatesAndActions.clear();
+}
+
+const statistics::RunningStatistics& statistics::StateActionStatistics::getCell(int i, int j, int k, int l) const{
+    return cells[i][j][k][l];
+}
+
+void statistics::StateActionStatistics::merge(const StateActionStatistics &other){
+    for (int i = 0; i <= environment::MAX_PLAYER_TOTAL; ++i){
+        for (int j = 0; j <= environment::MAX_DEALER_SHOWING; ++j){
+            for (int k = 0; k < environment::MAX_POSSIBLE_ACTIONS; ++k){
+                for (int l = 0; l < 2; ++l){
+                    cells[i][j][k][l].merge(other.cells[i][j][k][l]);
+                }
+            }
+        }
+    }
+}
+
+void statistics::StateActionStatistics::copyMeansTo(function::StateActionFunction &Q) const{
+    for (int i = 0; i <= environment::MAX_PLAYER_TOTAL; ++i){
+        for (int j = 0; j <= environment::MAX_DEALER_SHOWING; ++j){
+            for (int k = 0; k < environment::MAX_POSSIBLE_ACTIONS; ++k){
+                for (int l = 0; l < 2; ++l){
+                    if (cells[i][j][k][l].count > 0){
+                        *Q.getImage(i, j, k, l) = (float)cells[i][j][k][l].mean;
+                    }
+                }
+            }
+        }
+    }
+}
+
+statistics::StateActionStatistics statistics::estimateActionValues(
+    const policy::FrozenPolicy &frozenPolicy,
+    long long numberOfEpisodes,
+    std::uint64_t seed,
+    int numberOfThreads
+){
+    numberOfThreads = numberOfThreads > 0 ? numberOfThreads : std::max(1, (int)std::thread::hardware_concurrency());
+
+    std::vector<StateActionStatistics> threadStatistics(numberOfThreads);
+    std::vector<std::thread> threads;
+
+    for (int t = 0; t < numberOfThreads; ++t){
+        long long firstEpisode = numberOfEpisodes * t / numberOfThreads, lastEpisode = numberOfEpisodes * (t + 1) / numberOfThreads;
+
+        threads.emplace_back([&, t, firstEpisode, lastEpisode](){
+            agents::PolicyAgent agent(frozenPolicy);
+            environment::EnvironmentHandler testEnvironment;
+            const environment::GameState &state = testEnvironment.getState();
+
+            std::vector<training::StateAndAction> visitedStatesAndActions;
+            visitedStatesAndActions.reserve(training::MAX_RECORDED_STATES);
+
+            for (long long episode = firstEpisode; episode < lastEpisode; ++episode){
+                testEnvironment.reset(seed, (std::uint64_t)episode);
+                agent.reset();
+
+                while (state.getOutcome() == environment::GameResult::UNFINISHED){
+                    environment::Action action = agent.considerState(state);
+                    if (training::stateAndActionShouldBeRecorded(state)){
+                        visitedStatesAndActions.emplace_back(state, action);
+                    }
+                    testEnvironment.step(action);
+                }
+
+                threadStatistics[t].addReturn(visitedStatesAndActions, testEnvironment.observe().reward);
+            }
+        });
+    }
+
+    for (std::thread &thread: threads){
+        thread.join();
+    }
+
+    StateActionStatistics merged;
+    for (const StateActionStatistics &partial: threadStatistics){
+        merged.merge(partial);
+    }
+    return merged;
+}
+
+std::ostream& operator<<(std::ostream& o, const statistics::StateActionStatistics &s){
+    o << "Mean return +/- 95% interval (visits) of each visited pair, h = hit and s = stand\n";
+
+    for (int l = 0; l < 2; ++l){
+        o << (l ? "With" : "Without") << " usable ace:\n";
+        for (int i = 12; i <= environment::MAX_PLAYER_TOTAL; ++i){
+            for (int j = 2; j <= environment::MAX_DEALER_SHOWING; ++j){
+                for (int k = 0; k < environment::MAX_POSSIBLE_ACTIONS; ++k){
+                    const statistics::RunningStatistics &cell = s.getCell(i, j, k, l);
+                    if (cell.count > 0){
+                        o << "p: " << i << ", d: " << j << ", " << (k ? "h" : "s") << " -> " <<
+                            cell.mean << " +/- " << cell.halfWidth() << " (" << cell.count << ")\n";
+                    }
+                }
+            }
+        }
+    }
+    return o;
+}
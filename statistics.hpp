@@ -0,0 +1,75 @@
+#pragma once
+
+#ifndef STATISTICS_H
+
+#define STATISTICS_H
+
+#include <array>
+#include <vector>
+#include <cstdint>
+#include "training.hpp"
+#include "evaluation.hpp"
+
+/*  Running statistics of the returns that follow each state-action pair. Every pair keeps its count, mean and sum of
+    squared deviations (M2) side by side in one record, which Welford's method updates in a single pass per visit, so
+    the mean is always current and its confidence interval costs a square root. Tables filled by different threads
+    merge exactly as if one thread had seen every return. */
+namespace statistics {
+
+    /* The running statistics of one pair's returns */
+    struct RunningStatistics {
+        std::uint64_t count = 0;
+        double mean = 0.0, m2 = 0.0;
+
+        /* Welford's update: the deviation from the old mean times the deviation from the new one is added to M2 */
+        void add(double value);
+
+        /* Chan's pairwise combination, which adds the other's M2 and a correction for the distance between the means */
+        void merge(const RunningStatistics &other);
+
+        /* The unbiased sample variance, 0 below two values */
+        double variance() const;
+
+        double standardError() const;
+
+        /* Half the width of the interval of the mean at z standard errors, 95% by default */
+        double halfWidth(double z = evaluation::Z_95) const;
+    };
+
+    /* Indexed like StateActionFunction: player total, face up total, action and usable ace */
+    class StateActionStatistics {
+    public:
+        /* Adds a return to the pair's record */
+        void add(const environment::GameState &state, environment::Action action, double G);
+
+        /* Adds the return G to every recorded pair of an episode and clears them, as training::updateQValues does */
+        void addReturn(std::vector<training::StateAndAction> &visitedStatesAndActions, double G);
+
+        const RunningStatistics& getCell(int i, int j, int k, int l) const;
+
+        /* Merges another table's statistics into this one, pair by pair */
+        void merge(const StateActionStatistics &other);
+
+        /* Copies the mean return of every visited pair into Q, leaving the Q-Values of unvisited pairs untouched */
+        void copyMeansTo(function::StateActionFunction &Q) const;
+
+    private:
+        function::StateActionMatrix<std::array<RunningStatistics, 2>> cells{};
+    };
+
+    /*  Plays episodes [0, numberOfEpisodes) of the seed with a frozen policy across the given threads, 0 using every
+        hardware thread, and returns the statistics of the returns that followed each pair it took.
+        Each thread fills its own table over a contiguous range of episodes and the tables are merged in order,
+        so the counts do not depend on the threads and the means only differ by rounding. */
+    StateActionStatistics estimateActionValues(
+        const policy::FrozenPolicy &frozenPolicy,
+        long long numberOfEpisodes,
+        std::uint64_t seed,
+        int numberOfThreads = 0
+    );
+}
+
+/* Outputs the mean return of every visited pair with its 95% interval and count */
+std::ostream& operator<<(std::ostream& o, const statistics::StateActionStatistics &s);
+
+#endif /* STATISTICS_H */
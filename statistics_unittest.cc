@@ -0,0 +1,135 @@
+#include <gtest/gtest.h>
+
+#include <cmath>
+
+#include "statistics.hpp"
+#include "test_helpers.hpp"
+
+class StatisticsTests : public testing::Test {
+    protected:
+        test_helpers::SilencedNarration silenced;
+
+        /* Returns of a long run of mostly losing hands, with a few pushes and wins */
+        static double returnOf(int i){
+            return i % 7 == 0 ? 0.0 : (i % 3 == 0 ? 1.0 : -1.0);
+        }
+};
+
+TEST_F(StatisticsTests, OnePassMatchesTwoPasses){
+    const int numberOfValues = 1001;
+
+    statistics::RunningStatistics running;
+    double sum = 0.0;
+    for (int i = 0; i < numberOfValues; ++i){
+        running.add(returnOf(i));
+        sum += returnOf(i);
+    }
+
+    double mean = sum / numberOfValues, squaredDeviations = 0.0;
+    for (int i = 0; i < numberOfValues; ++i){
+        squaredDeviations += (returnOf(i) - mean) * (returnOf(i) - mean);
+    }
+    double variance = squaredDeviations / (numberOfValues - 1);
+
+    EXPECT_EQ((std::uint64_t)numberOfValues, running.count);
+    EXPECT_NEAR(mean, running.mean, 1e-12);
+    EXPECT_NEAR(variance, running.variance(), 1e-12);
+    EXPECT_NEAR(std::sqrt(variance / numberOfValues), running.standardError(), 1e-12);
+    EXPECT_NEAR(evaluation::Z_95 * running.standardError(), running.halfWidth(), 1e-12);
+
+    // One value has no spread to speak of
+    statistics::RunningStatistics single;
+    single.add(1.0);
+    EXPECT_EQ(0.0, single.variance());
+    EXPECT_EQ(0.0, single.halfWidth());
+}
+
+TEST_F(StatisticsTests, MergedPartialsMatchOnePass){
+    statistics::RunningStatistics whole, partials[3];
+    for (int i = 0; i < 3000; ++i){
+        whole.add(returnOf(i));
+
+        // Uneven parts, so the means being combined differ
+        partials[i < 100 ? 0 : (i < 2200 ? 1 : 2)].add(returnOf(i));
+    }
+
+    // Merging into and from an empty record copies the other
+    statistics::RunningStatistics merged;
+    merged.merge(statistics::RunningStatistics());
+    EXPECT_EQ(0u, merged.count);
+
+    for (const statistics::RunningStatistics &partial: partials){
+        merged.merge(partial);
+    }
+    merged.merge(statistics::RunningStatistics());
+
+    EXPECT_EQ(whole.count, merged.count);
+    EXPECT_NEAR(whole.mean, merged.mean, 1e-12);
+    EXPECT_NEAR(whole.m2, merged.m2, 1e-9);
+}
+
+TEST_F(StatisticsTests, TableIsIndexedLikeTheQValues){
+    environment::EnvironmentHandler testEnvironment;
+    testEnvironment.resetToState(16, 10, false);
+    environment::GameState hard16 = testEnvironment.getState();
+    testEnvironment.resetToState(18, 9, true);
+    environment::GameState soft18 = testEnvironment.getState();
+
+    statistics::StateActionStatistics table;
+    std::vector<training::StateAndAction> visitedStatesAndActions;
+
+    visitedStatesAndActions.emplace_back(hard16, environment::Action::HIT);
+    visitedStatesAndActions.emplace_back(soft18, environment::Action::STAND);
+    table.addReturn(visitedStatesAndActions, -1.0);
+    EXPECT_TRUE(visitedStatesAndActions.empty());
+
+    visitedStatesAndActions.emplace_back(hard16, environment::Action::HIT);
+    table.addReturn(visitedStatesAndActions, 1.0);
+
+    const statistics::RunningStatistics &hit16 = table.getCell(16, 10, 1, 0), &stand18 = table.getCell(18, 9, 0, 1);
+    EXPECT_EQ(2u, hit16.count);
+    EXPECT_DOUBLE_EQ(0.0, hit16.mean);
+    EXPECT_DOUBLE_EQ(2.0, hit16.variance());
+    EXPECT_EQ(1u, stand18.count);
+    EXPECT_DOUBLE_EQ(-1.0, stand18.mean);
+    EXPECT_EQ(0u, table.getCell(16, 10, 0, 0).count);
+
+    // Only the visited pairs are copied
+    function::StateActionFunction Q;
+    *Q.getImage(16, 10, 0, 0) = 0.25f;
+    table.copyMeansTo(Q);
+
+    EXPECT_EQ(0.0f, *Q.getImage(16, 10, 1, 0));
+    EXPECT_EQ(-1.0f, *Q.getImage(18, 9, 0, 1));
+    EXPECT_EQ(0.25f, *Q.getImage(16, 10, 0, 0));
+}
+
+TEST_F(StatisticsTests, ThreadsOnlyChangeTheRounding){
+    /* Hits below 12 and stands everywhere else */
+    policy::FrozenPolicy standOnTwelve;
+
+    statistics::StateActionStatistics single = statistics::estimateActionValues(standOnTwelve, 30000, 4, 1);
+    statistics::StateActionStatistics parallel = statistics::estimateActionValues(standOnTwelve, 30000, 4, 3);
+
+    std::uint64_t visits = 0;
+    for (int i = 12; i <= environment::MAX_PLAYER_TOTAL; ++i){
+        for (int j = 2; j <= environment::MAX_DEALER_SHOWING; ++j){
+            for (int l = 0; l < 2; ++l){
+                // Standing is the only action the policy takes
+                EXPECT_EQ(0u, single.getCell(i, j, 1, l).count);
+
+                const statistics::RunningStatistics &stand = single.getCell(i, j, 0, l), &parallelStand = parallel.getCell(i, j, 0, l);
+                EXPECT_EQ(stand.count, parallelStand.count);
+                EXPECT_NEAR(stand.mean, parallelStand.mean, 1e-12);
+                EXPECT_NEAR(stand.m2, parallelStand.m2, 1e-9);
+                visits += stand.count;
+            }
+        }
+    }
+
+    // Every hand reaches exactly one decision, since standing ends the player's turn
+    EXPECT_EQ(30000u, visits);
+
+    // Standing on 20 against a 6 wins far more often than it loses
+    EXPECT_GT(single.getCell(20, 6, 0, 0).mean - single.getCell(20, 6, 0, 0).halfWidth(), 0.0);
+}
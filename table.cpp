@@ -0,0 +1,221 @@
+#include "table.hpp"
+
+#include <cmath>
+#include <algorithm>
+
+table::Shoe::Shoe(int numberOfDecks, double penetration) : position(0), cutCard(0), shuffles(0) {
+    numberOfDecks = std::max(1, numberOfDecks);
+
+    for (int deck = 0; deck < numberOfDecks; ++deck){
+        for (int value = 1; value <= 9; ++value){
+            cards.insert(cards.end(), CARDS_OF_EACH_VALUE, (std::uint8_t)value);
+        }
+        cards.insert(cards.end(), CARDS_WORTH_TEN, (std::uint8_t)10);
+    }
+
+    // Starts out dealt, so the first round shuffles it
+    position = (int)cards.size();
+    cutCard = (int)std::lround(std::max(0.0, std::min(penetration, 1.0)) * (double)cards.size());
+}
+
+void table::Shoe::shuffle(){
+    // Fisher-Yates, so every order of the cards is equally likely
+    for (int i = (int)cards.size() - 1; i > 0; --i){
+        int j = (int)(environment::randomEngine()() % (environment::RandomEngine::result_type)(i + 1));
+        std::swap(cards[i], cards[j]);
+    }
+
+    position = 0;
+    ++shuffles;
+}
+
+int table::Shoe::draw(){
+    return cards[position++];
+}
+
+bool table::Shoe::reachedCutCard() const{
+    return position >= cutCard;
+}
+
+int table::Shoe::size() const{
+    return (int)cards.size();
+}
+
+int table::Shoe::getRemaining() const{
+    return (int)cards.size() - position;
+}
+
+long long table::Shoe::getShuffles() const{
+    return shuffles;
+}
+
+void table::Hand::add(int cardValue){
+    ++numberOfCards;
+
+    // The same rule as GameState::updateTotal
+    if (usableAce && total + cardValue > 21){
+        usableAce = false;
+        total += cardValue - 10;
+    } else if (cardValue == 1 && total + 11 <= 21){
+        usableAce = true;
+        total += 11;
+    } else {
+        total += cardValue;
+    }
+}
+
+void table::Hand::clear(){
+    total = numberOfCards = 0;
+    usableAce = false;
+}
+
+table::Table::Table(const TableConfig &config)
+    : faceupTotal(0), shoe(config.numberOfDecks, config.penetration), seed(config.seed) {}
+
+int table::Table::addSeat(const policy::FrozenPolicy &frozenPolicy){
+    if ((int)seats.size() >= MAX_SEATS){
+        return -1;
+    }
+
+    seats.push_back(Seat{&frozenPolicy, Hand(), environment::GameResult::UNFINISHED});
+    stats.seats.emplace_back();
+    return (int)seats.size() - 1;
+}
+
+int table::Table::getNumberOfSeats() const{
+    return (int)seats.size();
+}
+
+void table::Table::playRound(){
+    if (shoe.reachedCutCard()){
+        shuffleShoe();
+    }
+
+    for (Seat &seat: seats){
+        seat.hand.clear();
+    }
+    dealerHand.clear();
+
+    // Dealt in the order of a real table, one card around, the up card, a second card around and the hole card
+    for (Seat &seat: seats){
+        seat.hand.add(deal());
+    }
+    dealerHand.add(deal());
+    faceupTotal = dealerHand.total;
+
+    for (Seat &seat: seats){
+        seat.hand.add(deal());
+    }
+    dealerHand.add(deal());
+
+    // Each seat plays out its hand before the next, with totals below 12 hit by every frozen policy
+    bool anySeatStood = false;
+    for (Seat &seat: seats){
+        while (seat.hand.total <= environment::MAX_PLAYER_TOTAL &&
+            seat.frozenPolicy->decide(seat.hand.total, faceupTotal, seat.hand.usableAce) == environment::Action::HIT){
+            seat.hand.add(deal());
+        }
+
+        bool bust = seat.hand.total > environment::MAX_PLAYER_TOTAL;
+        seat.outcome = bust ? environment::GameResult::DEALER_WIN : environment::GameResult::UNFINISHED;
+        anySeatStood |= !bust;
+    }
+
+    // One playout of the dealer's hand settles every seat still in, and none is needed when every seat has bust
+    if (anySeatStood){
+        while (dealerHand.total < 17){
+            dealerHand.add(deal());
+        }
+        ++stats.dealerPlayouts;
+    }
+
+    for (int s = 0; s < (int)seats.size(); ++s){
+        Seat &seat = seats[s];
+
+        if (seat.outcome == environment::GameResult::UNFINISHED){
+            if (dealerHand.total > environment::MAX_PLAYER_TOTAL || seat.hand.total > dealerHand.total){
+                seat.outcome = environment::GameResult::PLAYER_WIN;
+            } else if (seat.hand.total < dealerHand.total){
+                seat.outcome = environment::GameResult::DEALER_WIN;
+            } else {
+                seat.outcome = environment::GameResult::PUSH;
+            }
+        }
+
+        stats.seats[s].add(seat.outcome);
+    }
+
+    ++stats.rounds;
+    stats.handsPlayed += (long long)seats.size();
+}
+
+environment::GameResult table::Table::getOutcome(int seat) const{
+    return seats[seat].outcome;
+}
+
+const table::Hand& table::Table::getHand(int seat) const{
+    return seats[seat].hand;
+}
+
+const table::Hand& table::Table::getDealerHand() const{
+    return dealerHand;
+}
+
+const table::TableStats& table::Table::getStats() const{
+    return stats;
+}
+
+int table::Table::deal(){
+    if (shoe.getRemaining() == 0){
+        shuffleShoe();
+    }
+
+    ++stats.cardsDealt;
+    return shoe.draw();
+}
+
+void table::Table::shuffleShoe(){
+    environment::seedEpisode(seed, (std::uint64_t)shoe.getShuffles());
+    shoe.shuffle();
+    stats.shuffles = shoe.getShuffles();
+}
+
+table::TableStats table::simulate(
+    const policy::FrozenPolicy &frozenPolicy,
+    int numberOfSeats,
+    long long numberOfRounds,
+    const TableConfig &config
+){
+    Table table(config);
+    for (int s = 0; s < std::max(1, std::min(numberOfSeats, MAX_SEATS)); ++s){
+        table.addSeat(frozenPolicy);
+    }
+
+    for (long long r = 0; r < numberOfRounds; ++r){
+        table.playRound();
+    }
+
+    return table.getStats();
+}
+
+evaluation::RewardTally table::combineSeats(const TableStats &stats){
+    evaluation::RewardTally combined;
+    for (const evaluation::RewardTally &seat: stats.seats){
+        combined.merge(seat);
+    }
+    return combined;
+}
+
+std::ostream& operator<<(std::ostream& o, const table::TableStats &s){
+    o << s.rounds << " rounds of " << s.seats.size() << (s.seats.size() == 1 ? " seat, " : " seats, ") << s.handsPlayed << " hands from " <<
+        s.cardsDealt << " cards and " << s.shuffles << " shuffles\n" <<
+        "Dealer playouts = " << s.dealerPlayouts << " (" <<
+        (s.dealerPlayouts > 0 ? (double)s.handsPlayed / (double)s.dealerPlayouts : 0.0) << " hands per playout)\n";
+
+    for (int seat = 0; seat < (int)s.seats.size(); ++seat){
+        const evaluation::RewardTally &tally = s.seats[seat];
+        o << "Seat " << seat + 1 << ": expected return = " <<
+            (tally.hands > 0 ? tally.rewardSum / (double)tally.hands : 0.0) << "\n";
+    }
+    return o;
+}
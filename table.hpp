@@ -0,0 +1,140 @@
+#pragma once
+
+#ifndef TABLE_H
+
+#define TABLE_H
+
+#include <vector>
+#include <cstdint>
+#include "evaluation.hpp"
+
+/*  A table of up to seven seats playing rounds against one dealer from a shared multi-deck shoe. Every seat's hand
+    depletes the same shoe, and the dealer's hand is played out once per round and settled against every seat still
+    standing, so each dealer resolution serves as many hands as there are seats.
+    The rules are the environment's: the dealer stands on every 17, a bust loses at once and naturals are not paid
+    extra. Hands are kept as totals rather than GameStates, which hold one card of each ID from a single deck, so
+    seats play frozen policies, which decide on totals alone. */
+namespace table {
+
+    const int MAX_SEATS = 7;
+
+    const int DEFAULT_NUMBER_OF_DECKS = 6;
+
+    /* The share of the shoe dealt before the cut card comes out, after which the shoe is shuffled between rounds */
+    const double DEFAULT_PENETRATION = 0.75;
+
+    /* The card values of one deck, aces as 1 and every face card as 10 */
+    const int CARDS_OF_EACH_VALUE = 4, CARDS_WORTH_TEN = 16;
+
+    /*  The cards of several decks, dealt in a shuffled order. Only values are kept, since nothing at the table
+        depends on a card's suit. */
+    class Shoe {
+    public:
+        Shoe(int numberOfDecks = DEFAULT_NUMBER_OF_DECKS, double penetration = DEFAULT_PENETRATION);
+
+        /* Puts every card back and shuffles them with the calling thread's generator */
+        void shuffle();
+
+        /* The value of the next card, there must be one left */
+        int draw();
+
+        /* Whether the cut card has come out, so the shoe should be shuffled before the next round */
+        bool reachedCutCard() const;
+
+        int size() const;
+
+        int getRemaining() const;
+
+        long long getShuffles() const;
+
+    private:
+        std::vector<std::uint8_t> cards;
+        int position, cutCard;
+        long long shuffles;
+    };
+
+    /* A hand counted like GameState counts one, an ace being 11 while that does not bust the hand */
+    struct Hand {
+        int total = 0, numberOfCards = 0;
+        bool usableAce = false;
+
+        void add(int cardValue);
+
+        void clear();
+    };
+
+    struct TableConfig {
+        int numberOfDecks = DEFAULT_NUMBER_OF_DECKS;
+        double penetration = DEFAULT_PENETRATION;
+
+        /* Shuffle s of the run is made with substream s of the seed, so a run depends only on its seed */
+        std::uint64_t seed = 0;
+    };
+
+    struct TableStats {
+        long long rounds = 0, handsPlayed = 0, cardsDealt = 0, shuffles = 0;
+
+        /* Rounds in which the dealer drew out their hand, which every seat not yet bust was settled against */
+        long long dealerPlayouts = 0;
+
+        /* The results of each seat */
+        std::vector<evaluation::RewardTally> seats;
+    };
+
+    class Table {
+    public:
+        explicit Table(const TableConfig &config = TableConfig());
+
+        /* Seats a policy, which must outlive the table, returning its seat or -1 when all MAX_SEATS are taken */
+        int addSeat(const policy::FrozenPolicy &frozenPolicy);
+
+        int getNumberOfSeats() const;
+
+        /*  Deals each seat a card, the dealer an up card, each seat a second card and the dealer a hole card,
+            lets every seat play out its hand in turn, then plays the dealer's hand once if any seat stood */
+        void playRound();
+
+        /* The outcome of each seat's hand in the last round */
+        environment::GameResult getOutcome(int seat) const;
+
+        const Hand& getHand(int seat) const;
+
+        const Hand& getDealerHand() const;
+
+        const TableStats& getStats() const;
+
+    private:
+        struct Seat {
+            const policy::FrozenPolicy *frozenPolicy;
+            Hand hand;
+            environment::GameResult outcome;
+        };
+
+        /*  Draws from the shoe, shuffling it first if a round runs it out, which only a shoe too small for the seats does.
+            The cards still on the table are then dealt again from the new shoe. */
+        int deal();
+
+        /* Shuffles the shoe with the next substream of the seed */
+        void shuffleShoe();
+
+        /* The face up total the seats decide against, an ace counting 11 */
+        int faceupTotal;
+
+        std::vector<Seat> seats;
+        Hand dealerHand;
+        Shoe shoe;
+
+        std::uint64_t seed;
+        TableStats stats;
+    };
+
+    /* Plays the policy at every seat of a table for the given number of rounds */
+    TableStats simulate(const policy::FrozenPolicy &frozenPolicy, int numberOfSeats, long long numberOfRounds, const TableConfig &config);
+
+    /* The results of every seat of a run together */
+    evaluation::RewardTally combineSeats(const TableStats &stats);
+}
+
+std::ostream& operator<<(std::ostream& o, const table::TableStats &s);
+
+#endif /* TABLE_H */
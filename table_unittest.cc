@@ -0,0 +1,122 @@
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <array>
+
+#include "table.hpp"
+#include "test_helpers.hpp"
+
+class TableTests : public testing::Test {
+    protected:
+        test_helpers::SilencedNarration silenced;
+
+        /* Hits below 12 and stands everywhere else */
+        policy::FrozenPolicy standOnTwelve;
+};
+
+TEST_F(TableTests, ShoeHoldsEveryCardOfEachDeck){
+    table::Shoe shoe(6);
+    EXPECT_EQ(6 * game_assets::DECK_SIZE, shoe.size());
+
+    environment::seedEpisode(3, 0);
+    shoe.shuffle();
+    EXPECT_EQ(shoe.size(), shoe.getRemaining());
+
+    std::array<int, 11> counts = {};
+    while (shoe.getRemaining() > 0){
+        ++counts[shoe.draw()];
+    }
+
+    for (int value = 1; value <= 9; ++value){
+        EXPECT_EQ(6 * table::CARDS_OF_EACH_VALUE, counts[value]);
+    }
+    EXPECT_EQ(6 * table::CARDS_WORTH_TEN, counts[10]);
+}
+
+TEST_F(TableTests, HandsCountLikeGameStates){
+    const int sequences[][5] = {
+        {1, 1, 9, 0, 0},    // Soft 21
+        {1, 6, 10, 0, 0},   // Soft 17 hit to a hard 17
+        {10, 1, 0, 0, 0},   // A natural
+        {1, 1, 1, 1, 10},   // Four aces and a ten
+        {9, 8, 7, 0, 0}     // Bust
+    };
+
+    static const game_assets::Deck deck;
+    for (const int *sequence: sequences){
+        table::Hand hand;
+        environment::GameState state;
+
+        // A different suit for each card and a jack for the fifth, so the state never drops a card it has already seen
+        for (int i = 0; i < 5 && sequence[i] != 0; ++i){
+            hand.add(sequence[i]);
+            state.addCard(deck[13 * (i % 4) + sequence[i] - 1 + (i == 4 ? 1 : 0)], true);
+        }
+
+        EXPECT_EQ(state.getPlayerTotal(), hand.total);
+        EXPECT_EQ(state.doesPlayerHaveUsableAce(), hand.usableAce);
+    }
+}
+
+TEST_F(TableTests, OneDealerPlayoutServesEverySeat){
+    table::TableConfig config;
+    config.seed = 5;
+
+    table::TableStats stats = table::simulate(standOnTwelve, table::MAX_SEATS, 20000, config);
+
+    EXPECT_EQ(20000, stats.rounds);
+    EXPECT_EQ(table::MAX_SEATS * 20000, stats.handsPlayed);
+    ASSERT_EQ(table::MAX_SEATS, (int)stats.seats.size());
+
+    // Standing on 12 never busts, so the dealer plays out every round, once for all seven seats
+    EXPECT_EQ(20000, stats.dealerPlayouts);
+    for (const evaluation::RewardTally &seat: stats.seats){
+        EXPECT_EQ(20000, seat.hands);
+    }
+
+    // A round of seven seats takes at least 16 cards, so a 312 card shoe dealt to 75% lasts at most 15 rounds
+    EXPECT_GE(stats.shuffles, 20000 / 15);
+    EXPECT_GE(stats.cardsDealt, 16 * 20000);
+}
+
+TEST_F(TableTests, FullTableIsRefused){
+    table::Table table;
+    for (int seat = 0; seat < table::MAX_SEATS; ++seat){
+        EXPECT_EQ(seat, table.addSeat(standOnTwelve));
+    }
+    EXPECT_EQ(-1, table.addSeat(standOnTwelve));
+    EXPECT_EQ(table::MAX_SEATS, table.getNumberOfSeats());
+}
+
+TEST_F(TableTests, RunsDependOnlyOnTheSeed){
+    table::TableConfig config;
+    config.seed = 9;
+
+    table::TableStats first = table::simulate(standOnTwelve, 3, 5000, config), second = table::simulate(standOnTwelve, 3, 5000, config);
+    EXPECT_EQ(first.cardsDealt, second.cardsDealt);
+    for (int seat = 0; seat < 3; ++seat){
+        EXPECT_EQ(first.seats[seat].rewardSum, second.seats[seat].rewardSum);
+    }
+}
+
+TEST_F(TableTests, OneSeatAtAFreshDeckPlaysLikeTheEnvironment){
+    // A single deck shuffled before every round deals one seat exactly the distribution of the environment's hands
+    table::TableConfig config;
+    config.numberOfDecks = 1;
+    config.penetration = 0.0;
+    config.seed = 1;
+
+    const long long numberOfHands = 400000;
+    evaluation::EvaluationResult atTable = evaluation::summarise(
+        table::combineSeats(table::simulate(standOnTwelve, 1, numberOfHands, config)), 0.0
+    );
+
+    evaluation::EvaluationConfig evaluationConfig;
+    evaluationConfig.maxHands = numberOfHands;
+    evaluationConfig.seed = 2;
+    evaluation::EvaluationResult inEnvironment = evaluation::evaluate(standOnTwelve, evaluationConfig);
+
+    // Independent runs, so their difference has a standard error of about sqrt(2) times either one's
+    double standardError = std::sqrt(atTable.standardError * atTable.standardError + inEnvironment.standardError * inEnvironment.standardError);
+    EXPECT_LT(std::fabs(atTable.expectedReturn - inEnvironment.expectedReturn), 4.0 * standardError);
+}
@@ -0,0 +1,29 @@
+#pragma once
+
+#ifndef TEST_HELPERS_H
+
+#define TEST_HELPERS_H
+
+#include "environment.hpp"
+
+/* Helpers shared by the unit tests */
+namespace test_helpers {
+
+    /*  Turns the narration of games off for as long as it lives. Fixtures that play episodes hold one, since the
+        episodes of a training run narrate nothing and a test of them should print nothing either. */
+    class SilencedNarration {
+    public:
+        SilencedNarration(){
+            environment::setNarration(false);
+        }
+
+        ~SilencedNarration(){
+            environment::setNarration(true);
+        }
+
+        SilencedNarration(const SilencedNarration&) = delete;
+        SilencedNarration& operator=(const SilencedNarration&) = delete;
+    };
+}
+
+#endif /* TEST_HELPERS_H */
@@ -0,0 +1,113 @@
+#include "trainer.hpp"
+#include "profiler.hpp"
+
+#include <atomic>
+#include <thread>
+#include <algorithm>
+
+trainer::Trainer::Trainer(const TrainerConfig &config)
+    : config(config), stepSizes(config.stepSizeConfig), agent(config.epsilon, config.decayRate), nextEpisode(1) {
+    testEnvironment.setSteppingMode(config.steppingMode);
+    visitedStatesAndActions.reserve(training::MAX_RECORDED_STATES);
+
+    // Exploring starts are only played one episode at a time
+    if (config.episodesInFlight > 1 && config.startMode == training::StartMode::NATURAL){
+        interleavedTrainer.reset(new interleaving::InterleavedTrainer(
+            Q, stepSizes, agent, config.seed, config.episodesInFlight, config.steppingMode
+        ));
+    }
+}
+
+void trainer::Trainer::train(long long numberOfEpisodes, const EpisodeObserver &onEpisodeEnd){
+    long long firstEpisode = nextEpisode, lastEpisode = nextEpisode + std::max(0LL, numberOfEpisodes);
+    nextEpisode = lastEpisode;
+
+    if (interleavedTrainer){
+        interleavedTrainer->train(firstEpisode, lastEpisode, [&](long long, float reward){
+            finishEpisode(reward, onEpisodeEnd);
+        });
+        return;
+    }
+
+    for (long long i = firstEpisode; i < lastEpisode; ++i){
+        PROFILE_SCOPE(profiler::Phase::EPISODE);
+
+        environment::narration() << "SIMULATION #" << i << ":\n";
+        finishEpisode(playEpisode((std::uint64_t)i), onEpisodeEnd);
+    }
+}
+
+const function::StateActionFunction& trainer::Trainer::getQ() const{
+    return Q;
+}
+
+function::StateActionFunction& trainer::Trainer::getQ(){
+    return Q;
+}
+
+const agents::GreedyAgent& trainer::Trainer::getAgent() const{
+    return agent;
+}
+
+const trainer::TrainerStats& trainer::Trainer::getStats() const{
+    return stats;
+}
+
+const trainer::TrainerConfig& trainer::Trainer::getConfig() const{
+    return config;
+}
+
+float trainer::Trainer::playEpisode(std::uint64_t episode){
+    switch (config.startMode){
+        case training::StartMode::EXPLORING:
+            return training::playExploringStartsEpisode(
+                testEnvironment, agent, Q, visitedStatesAndActions, stepSizes, config.seed, episode
+            );
+        case training::StartMode::PRIORITISED:
+            return sampling::playPrioritisedEpisode(
+                testEnvironment, agent, Q, visitedStatesAndActions, stepSizes, sampler, config.seed, episode
+            );
+        case training::StartMode::NATURAL:
+            break;
+    }
+
+    testEnvironment.reset(config.seed, episode);
+    return training::playControlEpisode(testEnvironment, agent, Q, visitedStatesAndActions, stepSizes);
+}
+
+void trainer::Trainer::finishEpisode(float reward, const EpisodeObserver &onEpisodeEnd){
+    ++stats.episodesCompleted;
+
+    // Bet as long as the winnings cover the bet
+    if (stats.currentWinnings >= WINNINGS_BET){
+        stats.currentWinnings += (long long)reward * WINNINGS_BET;
+        stats.highestWinnings = std::max(stats.highestWinnings, stats.currentWinnings);
+    }
+
+    stats.cumulativeReward += reward;
+
+    if (onEpisodeEnd){
+        onEpisodeEnd(*this);
+    }
+}
+
+void trainer::trainConcurrently(const std::vector<std::unique_ptr<Trainer>> &trainers, long long numberOfEpisodes, int numberOfThreads){
+    numberOfThreads = numberOfThreads > 0 ? numberOfThreads : std::max(1, (int)std::thread::hardware_concurrency());
+    numberOfThreads = std::max(1, std::min(numberOfThreads, (int)trainers.size()));
+
+    // Each thread takes the next trainer nobody has started until none are left, so a slow trainer holds up no other
+    std::atomic<std::size_t> nextTrainer(0);
+    std::vector<std::thread> threads;
+
+    for (int t = 0; t < numberOfThreads; ++t){
+        threads.emplace_back([&](){
+            for (std::size_t i = nextTrainer++; i < trainers.size(); i = nextTrainer++){
+                trainers[i]->train(numberOfEpisodes);
+            }
+        });
+    }
+
+    for (std::thread &thread: threads){
+        thread.join();
+    }
+}
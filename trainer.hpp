@@ -0,0 +1,115 @@
+#pragma once
+
+#ifndef TRAINER_H
+
+#define TRAINER_H
+
+#include <memory>
+#include <vector>
+#include <cstdint>
+#include <functional>
+#include "training.hpp"
+#include "sampling.hpp"
+#include "interleaving.hpp"
+
+/*  A Monte Carlo control run as an object. A Trainer owns everything its run updates: the Q-Values, the visit counts
+    behind the step sizes, the agent and its exploration, the environments its episodes are played in and the run's
+    winnings, so any number of trainers can run side by side in one process without sharing any state. The only
+    shared state an episode touches is the calling thread's generator, which every episode seeds afresh. */
+namespace trainer {
+
+    /* The bankroll a run starts its winnings with and the flat bet it places on every episode it can cover */
+    const long long INITIAL_WINNINGS = 1000;
+    const long long WINNINGS_BET = 5;
+
+    struct TrainerConfig {
+        /* Episode e is dealt from substream e of the seed, counting from 1 */
+        std::uint64_t seed = 0;
+
+        training::StepSizeConfig stepSizeConfig;
+
+        /* Games interleaved on the thread, 1 plays each episode to the end before the next */
+        int episodesInFlight = 1;
+
+        /* Whether the agent is also asked about the rounds it cannot change */
+        environment::SteppingMode steppingMode = environment::SteppingMode::DECISION_POINTS;
+
+        /* Whether episodes are dealt or start from a drawn decision state and first action, which are played one at a time */
+        training::StartMode startMode = training::StartMode::NATURAL;
+
+        /* The agent's initial exploration and its decay per episode, those of GreedyAgent() */
+        float epsilon = 1.0f, decayRate = 0.999f;
+    };
+
+    /* What a run has earned so far, betting WINNINGS_BET on each episode while its winnings cover it */
+    struct TrainerStats {
+        long long episodesCompleted = 0;
+
+        long long currentWinnings = INITIAL_WINNINGS, highestWinnings = 0;
+
+        /* The sum of every episode's reward */
+        double cumulativeReward = 0.0;
+    };
+
+    class Trainer;
+
+    /* Called as each episode finishes, after the trainer's statistics include it */
+    using EpisodeObserver = std::function<void(const Trainer &trainer)>;
+
+    class Trainer {
+    public:
+        explicit Trainer(const TrainerConfig &config = TrainerConfig());
+
+        /* The games in flight refer to the trainer's own tables and agent, so it stays where it was made */
+        Trainer(const Trainer&) = delete;
+        Trainer& operator=(const Trainer&) = delete;
+
+        /*  Plays and learns from the next numberOfEpisodes episodes, carrying on from where the last call stopped.
+            With one episode in flight, training in several calls gives the same Q-Values as training in one. */
+        void train(long long numberOfEpisodes, const EpisodeObserver &onEpisodeEnd = nullptr);
+
+        const function::StateActionFunction& getQ() const;
+
+        /* The Q-Values the run learns in, which a checkpoint can be loaded into to carry on from it */
+        function::StateActionFunction& getQ();
+
+        const agents::GreedyAgent& getAgent() const;
+
+        const TrainerStats& getStats() const;
+
+        const TrainerConfig& getConfig() const;
+
+    private:
+        /* Plays episode e and updates Q with its return, one episode at a time */
+        float playEpisode(std::uint64_t episode);
+
+        void finishEpisode(float reward, const EpisodeObserver &onEpisodeEnd);
+
+        TrainerConfig config;
+
+        function::StateActionFunction Q;
+        training::AdaptiveStepSize stepSizes;
+        agents::GreedyAgent agent;
+
+        /* The environment episodes are played in one at a time, reset for each rather than constructed again */
+        environment::EnvironmentHandler testEnvironment;
+        std::vector<training::StateAndAction> visitedStatesAndActions;
+
+        /* Learns which starts are uncertain from every episode of the run, only used with prioritised starts */
+        sampling::PrioritisedStartSampler sampler;
+
+        /* The games in flight, only used when several are interleaved */
+        std::unique_ptr<interleaving::InterleavedTrainer> interleavedTrainer;
+
+        TrainerStats stats;
+
+        /* The index of the next episode to be played */
+        long long nextEpisode;
+    };
+
+    /*  Trains every trainer for the given number of episodes on a pool of threads, 0 using every hardware thread.
+        Each trainer is trained by one thread from start to end, so its results are those of training it alone. */
+    void trainConcurrently(const std::vector<std::unique_ptr<Trainer>> &trainers, long long numberOfEpisodes, int numberOfThreads = 0);
+}
+
+#endif /* TRAINER_H */
@@ -0,0 +1,96 @@
+#include <gtest/gtest.h>
+
+#include <cstring>
+#include <algorithm>
+
+#include "trainer.hpp"
+#include "test_helpers.hpp"
+
+class TrainerTests : public testing::Test {
+    protected:
+        test_helpers::SilencedNarration silenced;
+
+        static bool sameQValues(const trainer::Trainer &first, const trainer::Trainer &second){
+            std::size_t tableBytes = sizeof(float);
+            for (int extent: function::FUNCTION_SHAPE){
+                tableBytes *= extent;
+            }
+            return std::memcmp(first.getQ().data(), second.getQ().data(), tableBytes) == 0;
+        }
+};
+
+TEST_F(TrainerTests, TrainingInSeveralCallsMatchesOneCall){
+    trainer::TrainerConfig config;
+    config.seed = 3;
+    config.stepSizeConfig.schedule = training::StepSizeSchedule::HARMONIC;
+
+    trainer::Trainer once(config), inParts(config);
+    once.train(6000);
+    inParts.train(1000);
+    inParts.train(2000);
+    inParts.train(3000);
+
+    EXPECT_TRUE(sameQValues(once, inParts));
+    EXPECT_EQ(6000, inParts.getStats().episodesCompleted);
+    EXPECT_EQ(once.getStats().cumulativeReward, inParts.getStats().cumulativeReward);
+    EXPECT_EQ(once.getStats().currentWinnings, inParts.getStats().currentWinnings);
+    EXPECT_EQ(once.getAgent().getEpsilon(), inParts.getAgent().getEpsilon());
+}
+
+TEST_F(TrainerTests, WinningsFollowTheRewards){
+    trainer::TrainerConfig config;
+    config.seed = 8;
+    trainer::Trainer trainer(config);
+
+    long long episodes = 0, winnings = trainer::INITIAL_WINNINGS, highest = 0;
+    double rewardSum = 0.0;
+
+    // The observer sees each episode after the trainer's statistics include it
+    trainer.train(20000, [&](const trainer::Trainer &finished){
+        const trainer::TrainerStats &stats = finished.getStats();
+        double reward = stats.cumulativeReward - rewardSum;
+
+        ++episodes;
+        if (winnings >= trainer::WINNINGS_BET){
+            winnings += (long long)reward * trainer::WINNINGS_BET;
+            highest = std::max(highest, winnings);
+        }
+        rewardSum = stats.cumulativeReward;
+
+        EXPECT_EQ(episodes, stats.episodesCompleted);
+        EXPECT_EQ(winnings, stats.currentWinnings);
+        EXPECT_EQ(highest, stats.highestWinnings);
+    });
+
+    EXPECT_EQ(20000, episodes);
+
+    // A policy that loses on average runs out of winnings long before 20000 episodes, after which it stops betting
+    EXPECT_LT(trainer.getStats().currentWinnings, trainer::WINNINGS_BET);
+    EXPECT_GE(trainer.getStats().currentWinnings, 0);
+}
+
+TEST_F(TrainerTests, ConcurrentTrainersMatchTrainingAlone){
+    // Every start mode and interleaving, so each kind of state the trainer owns is exercised side by side
+    std::vector<trainer::TrainerConfig> configs(5);
+    configs[1].startMode = training::StartMode::EXPLORING;
+    configs[2].startMode = training::StartMode::PRIORITISED;
+    configs[3].episodesInFlight = 8;
+    configs[4].steppingMode = environment::SteppingMode::EVERY_ROUND;
+
+    std::vector<std::unique_ptr<trainer::Trainer>> concurrent;
+    for (int t = 0; t < (int)configs.size(); ++t){
+        configs[t].seed = 100 + (std::uint64_t)t;
+        concurrent.emplace_back(new trainer::Trainer(configs[t]));
+    }
+
+    trainer::trainConcurrently(concurrent, 8000, 3);
+
+    for (int t = 0; t < (int)configs.size(); ++t){
+        trainer::Trainer alone(configs[t]);
+        alone.train(8000);
+
+        EXPECT_TRUE(sameQValues(alone, *concurrent[t])) << "Trainer " << t;
+        EXPECT_EQ(alone.getStats().cumulativeReward, concurrent[t]->getStats().cumulativeReward) << "Trainer " << t;
+        EXPECT_EQ(8000, concurrent[t]->getStats().episodesCompleted);
+    }
+}
@@ -0,0 +1,275 @@
+#include "training.hpp"
+#include "profiler.hpp"
+
+#include <cmath>
+#include <algorithm>
+
+bool training::stateAndActionShouldBeRecorded(const environment::GameState &state){
+    environment::narration() << "Now checking whether to record the current state and action\n";
+    environment::narration() << "The dealers face down cards are " << (state.dealerCardsShown() ? "":"not") << " shown.\n";
+    environment::narration() << "The player total is " << 
+        (state.getPlayerTotal() >= 12   ? "greater than or equal to 12":"less than 12") << ".\n";
+
+    return (
+        !state.dealerCardsShown() && 
+        state.getPlayerTotal() >= 12    
+    );
+}
+
+namespace {
+    /* Moves each visited pair's Q-Value towards the return G, by the step size stepSizeFor gives the pair */
+    template <typename StepSizeFor>
+    void applyUpdates(
+        function::StateActionFunction &Q,
+        std::vector<training::StateAndAction> &visitedStatesAndActions,
+        float G,
+        StepSizeFor stepSizeFor
+    ){
+        PROFILE_SCOPE(profiler::Phase::Q_UPDATE);
+
+        for (training::StateAndAction &p: visitedStatesAndActions){
+            environment::GameState &state = p.first;
+            environment::Action action = p.second;
+            environment::narration() << "Now updating the Q-Values for:\n" << state << "\n with action " << action << "\n using reward " << G << "\n";
+
+            float *QValue = Q(state, action);
+            float learningFactor = stepSizeFor(state, action);
+
+            environment::narration() << "Q-Value before = " << *QValue << "\n";
+            /* Calculate the updates to the Q-Value using the learning factor to prevent rapid and drastic changes */
+            *QValue = *QValue + learningFactor * (G - *QValue);
+
+            environment::narration() << "Q-Value after = " << *QValue << "\n";
+
+        }
+        // Clear the vector for future calculations
+        visitedStatesAndActions.clear();
+    }
+}
+
+training::AdaptiveStepSize::AdaptiveStepSize(const StepSizeConfig &config) : config(config) {
+    for (auto &row: visits){
+        for (auto &column: row){
+            for (auto &slice: column){
+                slice.fill(0);
+            }
+        }
+    }
+
+    for (int n = 0; n < STEP_SIZE_TABLE_SIZE; ++n){
+        stepSizes[n] = stepSize(config, (std::uint32_t)n);
+    }
+}
+
+float training::AdaptiveStepSize::next(const environment::GameState &state, environment::Action action){
+    return next(state.getPlayerTotal(), state.getFaceupTotal(), action, state.doesPlayerHaveUsableAce());
+}
+
+float training::AdaptiveStepSize::next(int playerTotal, int faceupTotal, environment::Action action, bool usableAce){
+    std::uint32_t &count = visits[playerTotal][faceupTotal][action == environment::Action::HIT][usableAce];
+
+    // Saturates rather than wrapping back to the large step sizes of the first visits
+    count += count != UINT32_MAX;
+
+    return count < (std::uint32_t)STEP_SIZE_TABLE_SIZE ? stepSizes[count] : stepSize(config, count);
+}
+
+std::uint32_t training::AdaptiveStepSize::getVisits(int i, int j, int k, int l) const{
+    return visits[i][j][k][l];
+}
+
+const training::StepSizeConfig& training::AdaptiveStepSize::getConfig() const{
+    return config;
+}
+
+float training::AdaptiveStepSize::stepSize(const StepSizeConfig &config, std::uint32_t visits){
+    // The first visit replaces the initial value of 0 outright under every decaying schedule
+    float n = (float)std::max(visits, (std::uint32_t)1);
+
+    switch (config.schedule){
+        case StepSizeSchedule::HARMONIC:
+            return 1.0f / n;
+        case StepSizeSchedule::POLYNOMIAL:
+            return 1.0f / std::pow(n, config.exponent);
+        case StepSizeSchedule::FLOOR_DECAY:
+            return std::max(config.learningFactor, 1.0f / (1.0f + (n - 1.0f) / config.decayVisits));
+        default:
+            return config.learningFactor;
+    }
+}
+
+void training::playRound(
+    environment::EnvironmentHandler &testEnvironment,
+    agents::GreedyAgent &agent,
+    function::StateActionFunction &Q,
+    std::vector<StateAndAction> &visitedStatesAndActions,
+    environment::Action &agentDecision
+){
+    const environment::GameState &state = testEnvironment.getState();
+
+    float *hitValue = Q(state, environment::Action::HIT), *standValue = Q(state, environment::Action::STAND);
+
+    // Check if the state is valid before allowing the agent to make a decision modifying itself in the process
+    // E.g. neither references returned from the function object should be null-pointers
+    if (hitValue != nullptr && standValue != nullptr){
+        // Tell the agent what the optimal values are for hitting and standing given all prior states
+        agent.setActionValues(*hitValue, *standValue);
+
+        // Consider the state and determine a decision to make
+        agentDecision = agent.considerState(state);
+
+        if (agentDecision == environment::Action::HIT) {
+            environment::narration() << "The agent chooses to hit.\n";
+        } else {
+            environment::narration() << "The agent chooses to stand.\n";
+        }
+
+        /* If first visit */
+        if (stateAndActionShouldBeRecorded(state)){
+            visitedStatesAndActions.emplace_back(state, agentDecision);
+        }
+    }
+
+    testEnvironment.step(agentDecision);
+}
+
+float training::playEpisode(
+    environment::EnvironmentHandler &testEnvironment,
+    agents::GreedyAgent &agent,
+    function::StateActionFunction &Q,
+    std::vector<StateAndAction> &visitedStatesAndActions
+){
+    // Refers to the environment's own state, so nothing is copied between rounds
+    const environment::GameState &state = testEnvironment.getState();
+
+    agent.reset();
+    environment::narration() << "Initial agent action = " << agent.getAction() << "\n";
+
+    environment::Action agentDecision = agent.getAction();
+
+    /* Policy control starts here */
+    while (state.getOutcome() == environment::GameResult::UNFINISHED){
+        playRound(testEnvironment, agent, Q, visitedStatesAndActions, agentDecision);
+    }
+
+    // Generate the reward value from the result of the game
+    return testEnvironment.observe().reward;
+}
+
+training::ExploringStart training::exploringStartFromIndex(int pair){
+    int numberOfFaceupTotals = environment::MAX_DEALER_SHOWING - LOWEST_FACEUP_TOTAL + 1;
+
+    ExploringStart start;
+    start.firstAction = environment::Action(pair % 2);
+    pair /= 2;
+    start.usableAce = pair % 2 == 1;
+    pair /= 2;
+    start.faceupTotal = LOWEST_FACEUP_TOTAL + pair % numberOfFaceupTotals;
+    start.playerTotal = LOWEST_DECISION_TOTAL + pair / numberOfFaceupTotals;
+    return start;
+}
+
+int training::exploringStartIndex(const ExploringStart &start){
+    int numberOfFaceupTotals = environment::MAX_DEALER_SHOWING - LOWEST_FACEUP_TOTAL + 1;
+    int state = (start.playerTotal - LOWEST_DECISION_TOTAL) * numberOfFaceupTotals + start.faceupTotal - LOWEST_FACEUP_TOTAL;
+
+    return (state * 2 + (start.usableAce ? 1 : 0)) * 2 + (start.firstAction == environment::Action::HIT ? 1 : 0);
+}
+
+training::ExploringStart training::drawExploringStart(){
+    // One draw picks the state and action together, so every pair is exactly as likely
+    return exploringStartFromIndex(
+        (int)(environment::randomEngine()() % (environment::RandomEngine::result_type)(2 * NUMBER_OF_STARTING_STATES))
+    );
+}
+
+void training::updateQValues(
+    function::StateActionFunction &Q,
+    std::vector<StateAndAction> &visitedStatesAndActions,
+    float G,
+    float learningFactor
+){
+    applyUpdates(Q, visitedStatesAndActions, G, [learningFactor](const environment::GameState&, environment::Action){
+        return learningFactor;
+    });
+}
+
+void training::updateQValues(
+    function::StateActionFunction &Q,
+    std::vector<StateAndAction> &visitedStatesAndActions,
+    float G,
+    AdaptiveStepSize &stepSizes
+){
+    applyUpdates(Q, visitedStatesAndActions, G, [&stepSizes](const environment::GameState &state, environment::Action action){
+        return stepSizes.next(state, action);
+    });
+}
+
+float training::playControlEpisode(
+    environment::EnvironmentHandler &testEnvironment,
+    agents::GreedyAgent &agent,
+    function::StateActionFunction &Q,
+    std::vector<StateAndAction> &visitedStatesAndActions,
+    float learningFactor
+){
+    float reward = playEpisode(testEnvironment, agent, Q, visitedStatesAndActions);
+
+    updateQValues(Q, visitedStatesAndActions, reward, learningFactor);
+
+    return reward;
+}
+
+float training::playControlEpisode(
+    environment::EnvironmentHandler &testEnvironment,
+    agents::GreedyAgent &agent,
+    function::StateActionFunction &Q,
+    std::vector<StateAndAction> &visitedStatesAndActions,
+    AdaptiveStepSize &stepSizes
+){
+    float reward = playEpisode(testEnvironment, agent, Q, visitedStatesAndActions);
+
+    updateQValues(Q, visitedStatesAndActions, reward, stepSizes);
+
+    return reward;
+}
+
+float training::playExploringStartsEpisode(
+    environment::EnvironmentHandler &testEnvironment,
+    agents::GreedyAgent &agent,
+    function::StateActionFunction &Q,
+    std::vector<StateAndAction> &visitedStatesAndActions,
+    AdaptiveStepSize &stepSizes,
+    std::uint64_t seed,
+    std::uint64_t episode
+){
+    environment::seedEpisode(seed, episode);
+    return playFromStart(testEnvironment, agent, Q, visitedStatesAndActions, stepSizes, drawExploringStart());
+}
+
+float training::playFromStart(
+    environment::EnvironmentHandler &testEnvironment,
+    agents::GreedyAgent &agent,
+    function::StateActionFunction &Q,
+    std::vector<StateAndAction> &visitedStatesAndActions,
+    AdaptiveStepSize &stepSizes,
+    const ExploringStart &start
+){
+    testEnvironment.resetToState(start.playerTotal, start.faceupTotal, start.usableAce);
+    const environment::GameState &state = testEnvironment.getState();
+
+    // The first action is taken for the agent, which keeps standing if it was a stand as though it had chosen it
+    visitedStatesAndActions.emplace_back(state, start.firstAction);
+    agent.reset();
+    agent.resume(start.firstAction);
+    testEnvironment.step(start.firstAction);
+
+    environment::Action agentDecision = start.firstAction;
+    while (state.getOutcome() == environment::GameResult::UNFINISHED){
+        playRound(testEnvironment, agent, Q, visitedStatesAndActions, agentDecision);
+    }
+
+    float reward = testEnvironment.observe().reward;
+    updateQValues(Q, visitedStatesAndActions, reward, stepSizes);
+
+    return reward;
+}
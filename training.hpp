@@ -0,0 +1,200 @@
+#pragma once
+
+#ifndef TRAINING_H
+
+#define TRAINING_H
+
+#include <array>
+#include <vector>
+#include <cstdint>
+#include <utility>
+#include "agents.hpp"
+#include "function.hpp"
+
+namespace training {
+
+    /* Stores a snapshot of the game's state alongside the action taken while in it*/
+    using StateAndAction = std::pair<environment::GameState, environment::Action>;
+
+    /* The constant step size used to move a Q-Value towards each new return */
+    const float LEARNING_FACTOR = 0.001f;
+
+    /*  Every recorded decision is followed by a dealt card or the end of the player's turn, so no episode records more
+        states than a hand can hold cards. Reserving this much up front means the scratch vector never grows mid run. */
+    const int MAX_RECORDED_STATES = environment::MAX_CARDS_PER_HAND;
+
+    /*
+     Takes a state and  whether it was visited with an action previously and determines whether it should be recorded.
+     States (and their related actions therein) should only be recorded if:
+        * The state and action pair has not been visited previously
+        * The player total is greater than or equal to 12 as a score under 12 is impossible to go bust on,
+            so no agent decision is necessary,
+        * The dealer is only showing one card, as the agent can make no further decisions after the dealer starts to
+            reveal their hand,
+     */
+    bool stateAndActionShouldBeRecorded(const environment::GameState &state);
+
+    /* How the step size of a state-action pair shrinks as the pair is visited more often */
+    enum class StepSizeSchedule :int {
+        CONSTANT = 0,   // learningFactor for every visit, the original behaviour
+        HARMONIC,       // 1 / N, which makes each Q-Value the plain average of its returns
+        POLYNOMIAL,     // 1 / N^exponent, which forgets the early returns of a changing policy faster than 1 / N
+        FLOOR_DECAY     // max(learningFactor, 1 / (1 + N / decayVisits)), fast at first then never below the floor
+    };
+
+    struct StepSizeConfig {
+        StepSizeSchedule schedule = StepSizeSchedule::CONSTANT;
+
+        /* The constant step size, and the floor of FLOOR_DECAY */
+        float learningFactor = LEARNING_FACTOR;
+
+        /* Between 0.5 and 1 for the Q-Values to still converge */
+        float exponent = 0.75f;
+
+        /* The visits it takes FLOOR_DECAY to halve its step size */
+        float decayVisits = 100.0f;
+    };
+
+    /* The decision states an exploring start is drawn from: player totals 12 to 21, dealer up cards 2 to 11, soft or hard */
+    const int LOWEST_DECISION_TOTAL = 12, LOWEST_FACEUP_TOTAL = 2;
+    const int NUMBER_OF_STARTING_STATES =
+        (environment::MAX_PLAYER_TOTAL - LOWEST_DECISION_TOTAL + 1) * (environment::MAX_DEALER_SHOWING - LOWEST_FACEUP_TOTAL + 1) * 2;
+
+    /* A decision state and the action first taken in it */
+    struct ExploringStart {
+        int playerTotal, faceupTotal;
+        bool usableAce;
+        environment::Action firstAction;
+    };
+
+    /* Numbers the state-action pairs an episode can start from, 0 to 2 * NUMBER_OF_STARTING_STATES - 1 */
+    ExploringStart exploringStartFromIndex(int pair);
+
+    int exploringStartIndex(const ExploringStart &start);
+
+    /* Draws a decision state and first action uniformly from the calling thread's generator */
+    ExploringStart drawExploringStart();
+
+    /* Where training episodes start */
+    enum class StartMode :int {
+        NATURAL = 0,    // A dealt hand, the original behaviour
+        EXPLORING,      // A state-action pair drawn uniformly
+        PRIORITISED     // A state-action pair drawn in proportion to the uncertainty of its return, see sampling.hpp
+    };
+
+    /* Step sizes for visit counts below this are looked up rather than computed */
+    const int STEP_SIZE_TABLE_SIZE = 4096;
+
+    /*  Counts the visits to every state-action pair and hands out the step size of the pair's next update.
+        The counts share the indexing of a StateActionFunction, and like it the whole table is a couple of kilobytes,
+        so both stay in cache side by side. Step sizes of the first STEP_SIZE_TABLE_SIZE visits are precomputed,
+        so an update costs one increment and one load whichever schedule is used. */
+    class AdaptiveStepSize {
+    public:
+        AdaptiveStepSize(const StepSizeConfig &config = StepSizeConfig());
+
+        /* Counts a visit to the pair and returns the step size its update should use */
+        float next(const environment::GameState &state, environment::Action action);
+
+        /* As above for a pair given by the indices of its state */
+        float next(int playerTotal, int faceupTotal, environment::Action action, bool usableAce);
+
+        /* The number of visits so far, indexed like StateActionFunction::getImage */
+        std::uint32_t getVisits(int i, int j, int k, int l) const;
+
+        const StepSizeConfig& getConfig() const;
+
+        /* The step size of the update made on the given visit, counting from 1 */
+        static float stepSize(const StepSizeConfig &config, std::uint32_t visits);
+
+    private:
+        StepSizeConfig config;
+
+        function::StateActionMatrix<std::array<std::uint32_t, 2>> visits;
+
+        std::array<float, STEP_SIZE_TABLE_SIZE> stepSizes;
+    };
+
+    /* Q-Value update function for control function */
+    void updateQValues(
+        function::StateActionFunction &Q,
+        std::vector<StateAndAction> &visitedStatesAndActions,
+        float G,
+        float learningFactor
+    );
+
+    /* Q-Value update function for control function, with a step size chosen for each state-action pair */
+    void updateQValues(
+        function::StateActionFunction &Q,
+        std::vector<StateAndAction> &visitedStatesAndActions,
+        float G,
+        AdaptiveStepSize &stepSizes
+    );
+
+    /*  Makes the agent's decision in the current state of an unfinished game, records it and steps the environment.
+        agentDecision is the previous decision, which is replayed in states Q holds no values for, and is updated
+        to the decision made. */
+    void playRound(
+        environment::EnvironmentHandler &testEnvironment,
+        agents::GreedyAgent &agent,
+        function::StateActionFunction &Q,
+        std::vector<StateAndAction> &visitedStatesAndActions,
+        environment::Action &agentDecision
+    );
+
+    /*  Plays the game the environment was last reset to with an epsilon-greedy agent, recording the visited pairs,
+        and returns its reward without updating Q, for callers that apply the updates themselves */
+    float playEpisode(
+        environment::EnvironmentHandler &testEnvironment,
+        agents::GreedyAgent &agent,
+        function::StateActionFunction &Q,
+        std::vector<StateAndAction> &visitedStatesAndActions
+    );
+
+    /*  Plays the game the environment was last reset to with an epsilon-greedy agent and updates Q with its return.
+        visitedStatesAndActions is only used as scratch space and is left empty, so reusing one environment
+        and one vector across episodes keeps the whole episode free of heap allocations. */
+    float playControlEpisode(
+        environment::EnvironmentHandler &testEnvironment,
+        agents::GreedyAgent &agent,
+        function::StateActionFunction &Q, // Stores the utility for each of the state-action pairs
+        std::vector<StateAndAction> &visitedStatesAndActions,
+        float learningFactor = LEARNING_FACTOR
+    );
+
+    /* As above, updating each visited pair with the step size its visit count calls for */
+    float playControlEpisode(
+        environment::EnvironmentHandler &testEnvironment,
+        agents::GreedyAgent &agent,
+        function::StateActionFunction &Q,
+        std::vector<StateAndAction> &visitedStatesAndActions,
+        AdaptiveStepSize &stepSizes
+    );
+
+    /*  Plays episode e of the seed from an exploring start: a decision state and first action drawn uniformly from
+        the episode's substream, after which the agent plays on as usual, then updates Q with its return.
+        Every pair is as likely to start an episode as any other, so rarely dealt pairs are covered in a few
+        thousand episodes rather than after millions of natural deals. */
+    float playExploringStartsEpisode(
+        environment::EnvironmentHandler &testEnvironment,
+        agents::GreedyAgent &agent,
+        function::StateActionFunction &Q,
+        std::vector<StateAndAction> &visitedStatesAndActions,
+        AdaptiveStepSize &stepSizes,
+        std::uint64_t seed,
+        std::uint64_t episode
+    );
+
+    /*  Plays an episode from the given start, with its cards drawn from the calling thread's generator,
+        then updates Q with its return */
+    float playFromStart(
+        environment::EnvironmentHandler &testEnvironment,
+        agents::GreedyAgent &agent,
+        function::StateActionFunction &Q,
+        std::vector<StateAndAction> &visitedStatesAndActions,
+        AdaptiveStepSize &stepSizes,
+        const ExploringStart &start
+    );
+}
+
+#endif /* TRAINING_H */
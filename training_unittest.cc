@@ -0,0 +1,229 @@
+#include <gtest/gtest.h>
+
+#include <new>
+#include <atomic>
+#include <cstdlib>
+
+#include "training.hpp"
+#include "test_helpers.hpp"
+
+namespace {
+    /* Counts every heap allocation made while counting is switched on */
+    std::atomic<bool> countingAllocations(false);
+    std::atomic<long long> numberOfAllocations(0);
+}
+
+void* operator new(std::size_t size){
+    if (countingAllocations.load(std::memory_order_relaxed)){
+        numberOfAllocations.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    void *memory = std::malloc(size ? size : 1);
+    if (memory == nullptr){
+        throw std::bad_alloc();
+    }
+    return memory;
+}
+
+void operator delete(void *memory) noexcept{
+    std::free(memory);
+}
+
+void operator delete(void *memory, std::size_t) noexcept{
+    std::free(memory);
+}
+
+class TrainingTests : public testing::Test {
+    protected:
+        test_helpers::SilencedNarration silenced;
+
+        TrainingTests(){
+            visitedStatesAndActions.reserve(training::MAX_RECORDED_STATES);
+        }
+
+        /* Plays episodes first..last-1 of seed 7, returning the summed reward, with adaptive step sizes if given */
+        float playEpisodes(int first, int last, training::AdaptiveStepSize *stepSizes = nullptr){
+            float rewards = 0.0f;
+            for (int i = first; i < last; ++i){
+                testEnvironment.reset(7, (std::uint64_t)i);
+                rewards += stepSizes != nullptr
+                    ? training::playControlEpisode(testEnvironment, agent, Q, visitedStatesAndActions, *stepSizes)
+                    : training::playControlEpisode(testEnvironment, agent, Q, visitedStatesAndActions);
+            }
+            return rewards;
+        }
+
+        environment::EnvironmentHandler testEnvironment;
+        agents::GreedyAgent agent;
+        function::StateActionFunction Q;
+        std::vector<training::StateAndAction> visitedStatesAndActions;
+};
+
+TEST_F(TrainingTests, EpisodesUpdateQAndClearVisitedStates){
+    playEpisodes(0, 1000);
+
+    EXPECT_TRUE(visitedStatesAndActions.empty());
+
+    // Some decision state must have had its value moved away from 0
+    int updatedImages = 0;
+    for (int i = 12; i <= environment::MAX_PLAYER_TOTAL; ++i){
+        for (int j = 2; j <= environment::MAX_DEALER_SHOWING; ++j){
+            updatedImages += *Q.getImage(i, j, 0, 0) != 0.0f;
+        }
+    }
+    EXPECT_GT(updatedImages, 0);
+}
+
+TEST_F(TrainingTests, DecisionPointsTrainTheSameValues){
+    playEpisodes(0, 2000);
+
+    // The greedy agent only draws a random number when it has a real decision, so the same cards are dealt
+    agents::GreedyAgent decidingAgent;
+    function::StateActionFunction decidingQ;
+    testEnvironment.setSteppingMode(environment::SteppingMode::DECISION_POINTS);
+
+    for (int i = 0; i < 2000; ++i){
+        testEnvironment.reset(7, (std::uint64_t)i);
+        training::playControlEpisode(testEnvironment, decidingAgent, decidingQ, visitedStatesAndActions);
+    }
+
+    for (int i = 0; i <= environment::MAX_PLAYER_TOTAL; ++i){
+        for (int j = 0; j <= environment::MAX_DEALER_SHOWING; ++j){
+            for (int k = 0; k < environment::MAX_POSSIBLE_ACTIONS; ++k){
+                for (int l = 0; l < 2; ++l){
+                    EXPECT_EQ(*Q.getImage(i, j, k, l), *decidingQ.getImage(i, j, k, l));
+                }
+            }
+        }
+    }
+}
+
+TEST_F(TrainingTests, ExploringStartsVisitEveryPair){
+    training::AdaptiveStepSize naturalVisits, exploringVisits;
+    playEpisodes(0, 4000, &naturalVisits);
+
+    agents::GreedyAgent exploringAgent;
+    function::StateActionFunction exploringQ;
+    for (int i = 0; i < 4000; ++i){
+        training::playExploringStartsEpisode(
+            testEnvironment, exploringAgent, exploringQ, visitedStatesAndActions, exploringVisits, 7, (std::uint64_t)i
+        );
+    }
+    EXPECT_TRUE(visitedStatesAndActions.empty());
+
+    int naturalPairsMissed = 0, exploringPairsMissed = 0;
+    for (int i = 12; i <= environment::MAX_PLAYER_TOTAL; ++i){
+        for (int j = 2; j <= environment::MAX_DEALER_SHOWING; ++j){
+            for (int k = 0; k < environment::MAX_POSSIBLE_ACTIONS; ++k){
+                for (int l = 0; l < 2; ++l){
+                    naturalPairsMissed += naturalVisits.getVisits(i, j, k, l) == 0;
+                    exploringPairsMissed += exploringVisits.getVisits(i, j, k, l) == 0;
+                }
+            }
+        }
+    }
+
+    // Natural deals rarely reach soft hands in which the greedy agent ever hits, exploring starts reach every pair
+    EXPECT_GT(naturalPairsMissed, 0);
+    EXPECT_EQ(0, exploringPairsMissed);
+}
+
+TEST_F(TrainingTests, SteadyStateEpisodesDoNotAllocate){
+    // Warm up, so the thread local generator and any lazily built statics already exist
+    playEpisodes(0, 1000);
+
+    numberOfAllocations.store(0);
+    countingAllocations.store(true);
+
+    playEpisodes(1000, 11000);
+
+    countingAllocations.store(false);
+
+    EXPECT_EQ(0, numberOfAllocations.load());
+}
+
+TEST_F(TrainingTests, AdaptiveEpisodesDoNotAllocate){
+    training::StepSizeConfig config;
+    config.schedule = training::StepSizeSchedule::POLYNOMIAL;
+    training::AdaptiveStepSize stepSizes(config);
+
+    playEpisodes(0, 1000, &stepSizes);
+
+    numberOfAllocations.store(0);
+    countingAllocations.store(true);
+
+    playEpisodes(1000, 11000, &stepSizes);
+
+    countingAllocations.store(false);
+
+    EXPECT_EQ(0, numberOfAllocations.load());
+}
+
+TEST_F(TrainingTests, ConstantScheduleMatchesTheFixedLearningFactor){
+    training::AdaptiveStepSize stepSizes;
+    playEpisodes(0, 2000, &stepSizes);
+
+    // Train a second table with the original fixed factor on the same episodes
+    environment::EnvironmentHandler fixedEnvironment;
+    agents::GreedyAgent fixedAgent;
+    function::StateActionFunction fixedQ;
+    for (int i = 0; i < 2000; ++i){
+        fixedEnvironment.reset(7, (std::uint64_t)i);
+        training::playControlEpisode(fixedEnvironment, fixedAgent, fixedQ, visitedStatesAndActions);
+    }
+
+    int numberOfImages = function::FUNCTION_SHAPE[0] * function::FUNCTION_SHAPE[1] * function::FUNCTION_SHAPE[2] * function::FUNCTION_SHAPE[3];
+    EXPECT_EQ(
+        std::vector<float>(fixedQ.data(), fixedQ.data() + numberOfImages),
+        std::vector<float>(Q.data(), Q.data() + numberOfImages)
+    );
+}
+
+TEST(StepSizeTests, SchedulesMatchTheirFormulas){
+    training::StepSizeConfig config;
+
+    EXPECT_FLOAT_EQ(training::LEARNING_FACTOR, training::AdaptiveStepSize::stepSize(config, 50));
+
+    config.schedule = training::StepSizeSchedule::HARMONIC;
+    EXPECT_FLOAT_EQ(1.0f, training::AdaptiveStepSize::stepSize(config, 1));
+    EXPECT_FLOAT_EQ(0.25f, training::AdaptiveStepSize::stepSize(config, 4));
+
+    config.schedule = training::StepSizeSchedule::POLYNOMIAL;
+    config.exponent = 0.5f;
+    EXPECT_FLOAT_EQ(0.25f, training::AdaptiveStepSize::stepSize(config, 16));
+
+    config.schedule = training::StepSizeSchedule::FLOOR_DECAY;
+    config.decayVisits = 10.0f;
+    EXPECT_FLOAT_EQ(1.0f, training::AdaptiveStepSize::stepSize(config, 1));
+    EXPECT_FLOAT_EQ(0.5f, training::AdaptiveStepSize::stepSize(config, 11));
+    EXPECT_FLOAT_EQ(config.learningFactor, training::AdaptiveStepSize::stepSize(config, 1000000));
+}
+
+TEST(StepSizeTests, HarmonicStepSizesAverageTheReturns){
+    training::StepSizeConfig config;
+    config.schedule = training::StepSizeSchedule::HARMONIC;
+    training::AdaptiveStepSize stepSizes(config);
+
+    function::StateActionFunction Q;
+    game_assets::Deck deck;
+
+    // Player 10 + 6 = 16 against a dealer 10
+    environment::GameState state;
+    state.addCard( deck[9], false );
+    state.addCard( deck[22], true );
+    state.addCard( deck[5], true );
+
+    std::vector<training::StateAndAction> visitedStatesAndActions;
+    const float returns[] = {1.0f, -1.0f, 1.0f, 1.0f, 0.0f};
+    {
+        test_helpers::SilencedNarration silenced;
+        for (float G: returns){
+            visitedStatesAndActions.emplace_back(state, environment::Action::HIT);
+            training::updateQValues(Q, visitedStatesAndActions, G, stepSizes);
+        }
+    }
+
+    EXPECT_FLOAT_EQ(0.4f, *Q(state, environment::Action::HIT));
+    EXPECT_EQ(5u, stepSizes.getVisits(16, 10, 1, 0));
+    EXPECT_EQ(0u, stepSizes.getVisits(16, 10, 0, 0));
+}
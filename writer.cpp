@@ -0,0 +1,113 @@
+#include "writer.hpp"
+
+#include <algorithm>
+
+writer::AsyncWriter::AsyncWriter(std::ostream &destination, int capacity) :
+    destination(destination), slots(std::max(1, capacity)), head(0), numberOfQueued(0),
+    numberOfQueuedTotal(0), numberOfWritten(0), droppedBuffers(0), batchesWritten(0), stopping(false) {
+    thread = std::thread(&AsyncWriter::run, this);
+}
+
+writer::AsyncWriter::AsyncWriter(const std::string &path, int capacity) :
+    file(path, std::ios::binary | std::ios::trunc), destination(file), slots(std::max(1, capacity)), head(0), numberOfQueued(0),
+    numberOfQueuedTotal(0), numberOfWritten(0), droppedBuffers(0), batchesWritten(0), stopping(false) {
+    thread = std::thread(&AsyncWriter::run, this);
+}
+
+writer::AsyncWriter::~AsyncWriter() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    queuedCondition.notify_one();
+    thread.join();
+}
+
+bool writer::AsyncWriter::tryWrite(std::string buffer) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (numberOfQueued == (int)slots.size()) {
+            ++droppedBuffers;
+            return false;
+        }
+        push(buffer);
+    }
+    queuedCondition.notify_one();
+    return true;
+}
+
+void writer::AsyncWriter::write(std::string buffer) {
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        writtenCondition.wait(lock, [this](){ return numberOfQueued < (int)slots.size(); });
+        push(buffer);
+    }
+    queuedCondition.notify_one();
+}
+
+void writer::AsyncWriter::flush() {
+    std::unique_lock<std::mutex> lock(mutex);
+    long long target = numberOfQueuedTotal;
+    writtenCondition.wait(lock, [this, target](){ return numberOfWritten >= target; });
+}
+
+bool writer::AsyncWriter::isOpen() const {
+    return &destination != &file || file.is_open();
+}
+
+long long writer::AsyncWriter::getDroppedBuffers() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return droppedBuffers;
+}
+
+long long writer::AsyncWriter::getBatchesWritten() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return batchesWritten;
+}
+
+/* Must be called with the mutex held and space in the queue, the buffer is moved rather than copied */
+void writer::AsyncWriter::push(std::string &buffer) {
+    slots[(head + numberOfQueued) % (int)slots.size()].swap(buffer);
+    ++numberOfQueued;
+    ++numberOfQueuedTotal;
+}
+
+void writer::AsyncWriter::run() {
+    // Kept across batches so taking buffers out of the queue does not allocate once it has grown
+    std::vector<std::string> batch;
+    batch.reserve(slots.size());
+
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+        queuedCondition.wait(lock, [this](){ return numberOfQueued > 0 || stopping; });
+
+        if (numberOfQueued == 0) {
+            // Only reached once stopping with nothing left to write
+            break;
+        }
+
+        // Take every queued buffer, leaving the slots empty for the producers
+        int numberOfTaken = numberOfQueued;
+        for (int i = 0; i < numberOfTaken; ++i) {
+            batch.emplace_back();
+            batch.back().swap(slots[head]);
+            head = (head + 1) % (int)slots.size();
+        }
+        numberOfQueued = 0;
+
+        // Producers can queue more while the batch is written
+        lock.unlock();
+        writtenCondition.notify_all();
+
+        for (const std::string &buffer: batch) {
+            destination.write(buffer.data(), (std::streamsize)buffer.size());
+        }
+        destination.flush();
+        batch.clear();
+
+        lock.lock();
+        numberOfWritten += numberOfTaken;
+        ++batchesWritten;
+        writtenCondition.notify_all();
+    }
+}
@@ -0,0 +1,76 @@
+#pragma once
+
+#ifndef WRITER_H
+
+#define WRITER_H
+
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <fstream>
+#include <iostream>
+#include <condition_variable>
+
+namespace writer {
+
+    /* The number of buffers that can be waiting to be written before the queue is full */
+    const int DEFAULT_QUEUE_CAPACITY = 1024;
+
+    /*  Writes preformatted or binary buffers to a stream from a dedicated thread.
+        Producers only move a buffer into a bounded queue, which never waits on the destination.
+        The writer thread takes every queued buffer at once and writes them as one batch followed by a single flush. */
+    class AsyncWriter {
+    public:
+        /* The destination must outlive the writer */
+        AsyncWriter(std::ostream &destination, int capacity = DEFAULT_QUEUE_CAPACITY);
+
+        /* Writes to a file, replacing anything it held before */
+        AsyncWriter(const std::string &path, int capacity = DEFAULT_QUEUE_CAPACITY);
+
+        /* Writes and flushes everything still queued before the thread is joined */
+        ~AsyncWriter();
+
+        AsyncWriter(const AsyncWriter&) = delete;
+        AsyncWriter& operator=(const AsyncWriter&) = delete;
+
+        /*  Queues a buffer without ever blocking, for output that can be lost, e.g. progress logs.
+            Returns false and counts the buffer as dropped when the queue is full. */
+        bool tryWrite(std::string buffer);
+
+        /* Queues a buffer, waiting for space when the queue is full, for output that must not be lost */
+        void write(std::string buffer);
+
+        /* Waits until everything queued before the call has been written and the destination flushed */
+        void flush();
+
+        /* Whether the file could be opened, always true for a stream */
+        bool isOpen() const;
+
+        long long getDroppedBuffers() const;
+
+        long long getBatchesWritten() const;
+
+    private:
+        std::ofstream file;
+        std::ostream &destination;
+
+        /* A ring of capacity slots holding the queued buffers from head onwards */
+        std::vector<std::string> slots;
+        int head, numberOfQueued;
+
+        /* Buffers are numbered as they are queued, so flush can wait for a particular one to be written */
+        long long numberOfQueuedTotal, numberOfWritten, droppedBuffers, batchesWritten;
+        bool stopping;
+
+        mutable std::mutex mutex;
+        std::condition_variable queuedCondition, writtenCondition;
+        std::thread thread;
+
+        void push(std::string &buffer);
+
+        void run();
+    };
+}
+
+#endif /* WRITER_H */
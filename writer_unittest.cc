@@ -0,0 +1,106 @@
+#include <gtest/gtest.h>
+
+#include <mutex>
+#include <cstdio>
+#include <sstream>
+#include <condition_variable>
+
+#include "writer.hpp"
+
+namespace {
+    /* A stream buffer that holds up every write until it is opened, like a disk that has stalled */
+    class GatedBuffer : public std::stringbuf {
+    public:
+        /* Waits until a write has reached the buffer and is being held up */
+        void waitUntilHeld(){
+            std::unique_lock<std::mutex> lock(mutex);
+            condition.wait(lock, [this](){ return isHeld; });
+        }
+
+        void open(){
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                isOpen = true;
+            }
+            condition.notify_all();
+        }
+
+    protected:
+        std::streamsize xsputn(const char *characters, std::streamsize count) override {
+            std::unique_lock<std::mutex> lock(mutex);
+            isHeld = true;
+            condition.notify_all();
+            condition.wait(lock, [this](){ return isOpen; });
+            return std::stringbuf::xsputn(characters, count);
+        }
+
+    private:
+        std::mutex mutex;
+        std::condition_variable condition;
+        bool isOpen = false, isHeld = false;
+    };
+}
+
+TEST(WriterTests, WritesBuffersInOrder){
+    std::ostringstream destination;
+    {
+        writer::AsyncWriter output(destination, 4);
+        for (int i = 0; i < 100; ++i){
+            output.write(std::to_string(i) + ",");
+        }
+        // The destructor writes whatever is still queued
+    }
+
+    std::string expected;
+    for (int i = 0; i < 100; ++i){
+        expected += std::to_string(i) + ",";
+    }
+    EXPECT_EQ(expected, destination.str());
+}
+
+TEST(WriterTests, FlushWaitsForEverythingQueued){
+    std::ostringstream destination;
+    writer::AsyncWriter output(destination);
+
+    output.write("checkpoint");
+    output.tryWrite(std::string("\0binary", 7));
+    output.flush();
+
+    EXPECT_EQ(std::string("checkpoint\0binary", 17), destination.str());
+    EXPECT_GE(output.getBatchesWritten(), 1);
+}
+
+TEST(WriterTests, TryWriteDropsInsteadOfBlocking){
+    GatedBuffer gate;
+    std::ostream destination(&gate);
+    writer::AsyncWriter output(destination, 2);
+
+    // The first buffer is taken by the writer thread, which then stalls writing it
+    output.write("a");
+    gate.waitUntilHeld();
+
+    // The queue fills up behind the stalled write, then further buffers are dropped
+    EXPECT_TRUE(output.tryWrite("b"));
+    EXPECT_TRUE(output.tryWrite("c"));
+    EXPECT_FALSE(output.tryWrite("d"));
+    EXPECT_EQ(1, output.getDroppedBuffers());
+
+    gate.open();
+    output.flush();
+    EXPECT_EQ("abc", gate.str());
+}
+
+TEST(WriterTests, WritesToAFile){
+    const std::string path = testing::TempDir() + "writer_unittest.txt";
+    {
+        writer::AsyncWriter output(path);
+        ASSERT_TRUE(output.isOpen());
+        output.write("line\n");
+    }
+
+    std::ifstream file(path);
+    std::string line;
+    std::getline(file, line);
+    EXPECT_EQ("line", line);
+    std::remove(path.c_str());
+}